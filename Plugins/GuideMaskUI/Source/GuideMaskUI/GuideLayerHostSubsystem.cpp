@@ -0,0 +1,225 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideLayerHostSubsystem.h"
+#include "GuideMaskRegistrySubsystem.h"
+
+#include "../GuideMaskUI/UI/GuideLayerBase.h"
+#include "../GuideMaskUI/GuideMaskSettings.h"
+
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Blueprint/UserWidget.h"
+#include "Widgets/SOverlay.h"
+
+
+UGuideLayerHostSubsystem* UGuideLayerHostSubsystem::Get(const UObject* WorldContextObject)
+{
+	ULocalPlayer* LocalPlayer = UGuideMaskRegistrySubsystem::FindLocalPlayerOrFirst(WorldContextObject);
+	return nullptr != LocalPlayer ? LocalPlayer->GetSubsystem<UGuideLayerHostSubsystem>() : nullptr;
+}
+
+UGuideLayerHostSubsystem* UGuideLayerHostSubsystem::Get(const UUserWidget* InLayer)
+{
+	if (nullptr == InLayer)
+	{
+		return nullptr;
+	}
+
+	if (ULocalPlayer* LocalPlayer = InLayer->GetOwningLocalPlayer())
+	{
+		return LocalPlayer->GetSubsystem<UGuideLayerHostSubsystem>();
+	}
+
+	return Get(static_cast<const UObject*>(InLayer));
+}
+
+UGuideLayerBase* UGuideLayerHostSubsystem::AcquireLayer(TSubclassOf<UGuideLayerBase> InLayerClass)
+{
+	if (nullptr == InLayerClass)
+	{
+		return nullptr;
+	}
+
+	ULocalPlayer* LocalPlayer = GetLocalPlayer();
+	UWorld* World = nullptr != LocalPlayer ? LocalPlayer->GetWorld() : nullptr;
+	if (nullptr == World)
+	{
+		return nullptr;
+	}
+
+	APlayerController* PlayerController = LocalPlayer->GetPlayerController(World);
+
+	for (int32 i = PooledLayers.Num() - 1; i >= 0; --i)
+	{
+		UGuideLayerBase* Pooled = PooledLayers[i];
+		if (nullptr != Pooled && InLayerClass == Pooled->GetClass() && World == Pooled->GetWorld() && PlayerController == Pooled->GetOwningPlayer())
+		{
+			PooledLayers.RemoveAtSwap(i);
+			return Pooled;
+		}
+	}
+
+	// Owned by this player, so the layer lays out and projects in the player's split-screen region.
+	if (nullptr != PlayerController)
+	{
+		return CreateWidget<UGuideLayerBase>(PlayerController, InLayerClass);
+	}
+
+	return CreateWidget<UGuideLayerBase>(World, InLayerClass);
+}
+
+bool UGuideLayerHostSubsystem::AddLayer(UGuideLayerBase* InLayer, int32 InZOrder)
+{
+	if (nullptr == InLayer)
+	{
+		return false;
+	}
+
+	if (true == IsHosting(InLayer))
+	{
+		return true;
+	}
+
+	if (false == EnsureHost())
+	{
+		return false;
+	}
+
+	TSharedRef<SWidget> LayerWidget = InLayer->TakeWidget();
+
+	HostOverlay->AddSlot(InZOrder)
+	[
+		LayerWidget
+	];
+
+	Layers.Emplace(InLayer);
+	LayerWidgets.Emplace(LayerWidget);
+
+	HostOverlay->SetVisibility(EVisibility::SelfHitTestInvisible);
+
+	return true;
+}
+
+bool UGuideLayerHostSubsystem::RemoveLayer(UGuideLayerBase* InLayer)
+{
+	const int32 Index = Layers.IndexOfByKey(InLayer);
+	if (INDEX_NONE == Index)
+	{
+		return false;
+	}
+
+	TSharedPtr<SWidget> LayerWidget = LayerWidgets[Index].Pin();
+	if (HostOverlay.IsValid() && LayerWidget.IsValid())
+	{
+		HostOverlay->RemoveSlot(LayerWidget.ToSharedRef());
+	}
+
+	Layers.RemoveAt(Index);
+	LayerWidgets.RemoveAt(Index);
+
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	if (nullptr != InLayer && nullptr != Settings && PooledLayers.Num() < Settings->LayerPoolSize)
+	{
+		InLayer->ResetGuide();
+		InLayer->OnGuideFinished.Clear();
+
+		PooledLayers.AddUnique(InLayer);
+	}
+
+	// An empty host is skipped by paint and hit test.
+	if (HostOverlay.IsValid() && 0 == Layers.Num())
+	{
+		HostOverlay->SetVisibility(EVisibility::Collapsed);
+	}
+
+	return true;
+}
+
+bool UGuideLayerHostSubsystem::IsHosting(const UGuideLayerBase* InLayer) const
+{
+	return nullptr != InLayer && Layers.Contains(InLayer);
+}
+
+void UGuideLayerHostSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FWorldDelegates::OnWorldCleanup.AddUObject(this, &UGuideLayerHostSubsystem::OnWorldCleanup);
+}
+
+void UGuideLayerHostSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldCleanup.RemoveAll(this);
+	ReleaseHost();
+
+	Super::Deinitialize();
+}
+
+bool UGuideLayerHostSubsystem::EnsureHost()
+{
+	// Map travel clears the viewport widgets, the host and the layers of the old world go with it.
+	if (HostOverlay.IsValid() && false == HostOverlay->IsParentValid())
+	{
+		ReleaseHost();
+	}
+
+	if (HostOverlay.IsValid())
+	{
+		return true;
+	}
+
+	ULocalPlayer* LocalPlayer = GetLocalPlayer();
+	UGameViewportClient* ViewportClient = nullptr != LocalPlayer ? LocalPlayer->ViewportClient : nullptr;
+	if (nullptr == ViewportClient)
+	{
+		return false;
+	}
+
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+
+	SAssignNew(HostOverlay, SOverlay)
+		.Visibility(EVisibility::SelfHitTestInvisible);
+
+	ViewportClient->AddViewportWidgetForPlayer(LocalPlayer, HostOverlay.ToSharedRef(), nullptr != Settings ? Settings->HostZOrder : 0);
+
+	return true;
+}
+
+void UGuideLayerHostSubsystem::ReleaseHost()
+{
+	if (HostOverlay.IsValid())
+	{
+		HostOverlay->ClearChildren();
+
+		ULocalPlayer* LocalPlayer = GetLocalPlayer();
+		if (nullptr != LocalPlayer && nullptr != LocalPlayer->ViewportClient)
+		{
+			LocalPlayer->ViewportClient->RemoveViewportWidgetForPlayer(LocalPlayer, HostOverlay.ToSharedRef());
+		}
+	}
+
+	HostOverlay.Reset();
+	Layers.Reset();
+	LayerWidgets.Reset();
+	PooledLayers.Reset();
+}
+
+void UGuideLayerHostSubsystem::OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources)
+{
+	// Layers must not keep the old world alive.
+	for (int32 i = Layers.Num() - 1; i >= 0; --i)
+	{
+		if (nullptr == Layers[i] || InWorld == Layers[i]->GetWorld())
+		{
+			RemoveLayer(Layers[i]);
+		}
+	}
+
+	PooledLayers.RemoveAll([InWorld](const UGuideLayerBase* InLayer)
+		{
+			return nullptr == InLayer || InWorld == InLayer->GetWorld();
+		});
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+
+#include "GuideLayerHostSubsystem.generated.h"
+
+class SOverlay;
+class SWidget;
+class UGuideLayerBase;
+class UUserWidget;
+
+/**
+ * One overlay per local player that holds every guide layer.
+ * The overlay is added to the viewport once, showing or hiding a guide only adds or removes one of its slots.
+ * Removed layers are kept in a small pool and handed out again with their guide box.
+ */
+UCLASS()
+class GUIDEMASKUI_API UGuideLayerHostSubsystem : public ULocalPlayerSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UGuideLayerHostSubsystem* Get(const UObject* WorldContextObject);
+	static UGuideLayerHostSubsystem* Get(const UUserWidget* InLayer);
+
+	/** A free pooled layer of the class, or a new one. The layer still has to be added. */
+	UGuideLayerBase* AcquireLayer(TSubclassOf<UGuideLayerBase> InLayerClass);
+
+	/** Z-order is only relative to the other guide layers of the host. */
+	bool AddLayer(UGuideLayerBase* InLayer, int32 InZOrder = 0);
+
+	/** Returns false if the layer isn't hosted here. The layer is reset and pooled while the pool has room. */
+	bool RemoveLayer(UGuideLayerBase* InLayer);
+
+	bool IsHosting(const UGuideLayerBase* InLayer) const;
+
+	int32 GetLayerCount() const { return Layers.Num(); }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	bool EnsureHost();
+	void ReleaseHost();
+
+	void OnWorldCleanup(UWorld* InWorld, bool bSessionEnded, bool bCleanupResources);
+
+private:
+	TSharedPtr<SOverlay> HostOverlay;
+
+	UPROPERTY(Transient)
+	TArray<UGuideLayerBase*> Layers;
+
+	// Slate widget of each layer, in the same order as Layers.
+	TArray<TWeakPtr<SWidget>> LayerWidgets;
+
+	UPROPERTY(Transient)
+	TArray<UGuideLayerBase*> PooledLayers;
+};
@@ -6,94 +6,127 @@
 #include "Components/TreeView.h"
 
 
-UGuideListEntryAsyncAction* UGuideListEntryAsyncAction::Create(UObject* InWorldContextObject, UListView* InListView, UObject* InListItem, float InTimeout)
+namespace GuideListEntryAsyncAction
 {
-	UGuideListEntryAsyncAction* NewAction = NewObject<UGuideListEntryAsyncAction>();
-	NewAction->WorldContext = InWorldContextObject;
-	NewAction->ListViewPtr = InListView;
-	NewAction->ItemPtr = InListItem;
-	NewAction->Timeout = FMath::Max(0.5f, InTimeout);
-	//NewAction->bDoScroll = bScrollIntoView;
-
-	return NewAction;
-}
-
-void UGuideListEntryAsyncAction::Activate()
-{
-	if (nullptr == ListViewPtr || nullptr == ItemPtr)
+	// Child items of a tree are only known to the tree's own getter.
+	struct FTreeViewAccess : public UTreeView
 	{
-		Fail();
-		return;
-	}
+		using UTreeView::OnGetChildrenInternal;
+	};
 
-
-	if (UUserWidget* EntryWidget = ListViewPtr->GetEntryWidgetFromItem(ItemPtr))
+	void GetTreeItemChildren(UTreeView* InTreeView, UObject* InItem, OUT TArray<UObject*>& OutChildren)
 	{
-		Success(EntryWidget);
+		void (UTreeView::*GetChildren)(UObject*, TArray<UObject*>&) const = &FTreeViewAccess::OnGetChildrenInternal;
+		(InTreeView->*GetChildren)(InItem, OutChildren);
 	}
 
-	else
+	bool FindTreeItemPath(UTreeView* InTreeView, UObject* InItem, TFunctionRef<bool(UObject*)> InPredicate, TSet<UObject*>& InVisited, OUT TArray<UObject*>& OutItemPath)
 	{
-		ListViewPtr->OnItemScrolledIntoView().AddUObject(this, &UGuideListEntryAsyncAction::HandleItemScrolledIntoView);
-
-		int Index = ListViewPtr->GetListItems().IndexOfByPredicate([&](UObject* InItem)
-			{
-				return InItem == ItemPtr;
-			});
-
-		if (Index != INDEX_NONE)
+		if (nullptr == InItem || true == InVisited.Contains(InItem))
 		{
-			ListViewPtr->ScrollIndexIntoView(Index);
-
-			StartTime = FPlatformTime::Seconds();
+			return false;
+		}
 
-#if ENGINE_MAJOR_VERSION >= 5
-			FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
-			TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
-				FTickerDelegate::CreateUObject(this, &UGuideListEntryAsyncAction::Tick));
-#else
-			FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
-			TickerHandle = FTicker::GetCoreTicker().AddTicker(
-				FTickerDelegate::CreateUObject(this, &UGuideListEntryAsyncAction::Tick));
-#endif
+		InVisited.Emplace(InItem);
+		OutItemPath.Emplace(InItem);
 
+		if (true == InPredicate(InItem))
+		{
+			return true;
 		}
 
-		else
+		TArray<UObject*> Children;
+		GetTreeItemChildren(InTreeView, InItem, OUT Children);
+
+		for (UObject* Child : Children)
 		{
-			Fail();
+			if (true == FindTreeItemPath(InTreeView, Child, InPredicate, InVisited, OutItemPath))
+			{
+				return true;
+			}
 		}
+
+		OutItemPath.Pop();
+		return false;
 	}
+}
+
+
+UGuideListEntryAsyncAction* UGuideListEntryAsyncAction::Create(UObject* InWorldContextObject, UListView* InListView, UObject* InListItem, float InTimeout)
+{
+	UGuideListEntryAsyncAction* NewAction = NewObject<UGuideListEntryAsyncAction>();
+	NewAction->WorldContext = InWorldContextObject;
+	NewAction->ListViewPtr = InListView;
+	NewAction->ItemPtr = InListItem;
+	NewAction->Timeout = InTimeout;
+
+	// The wait only holds the action weakly, the game instance keeps it alive until it finishes.
+	NewAction->RegisterWithGameInstance(InWorldContextObject);
 
+	return NewAction;
 }
 
-void UGuideListEntryAsyncAction::HandleItemScrolledIntoView(UObject* Item, UUserWidget& EntryWidget)
+UGuideListEntryAsyncAction* UGuideListEntryAsyncAction::CreateForTree(UObject* InWorldContextObject, UTreeView* InTreeView, const TArray<UObject*>& InItemPath, float InTimeout)
 {
-	if (Item == ItemPtr)
+	UGuideListEntryAsyncAction* NewAction = Create(InWorldContextObject, InTreeView, 0 < InItemPath.Num() ? InItemPath.Last() : nullptr, InTimeout);
+
+	for (int i = 0; i < InItemPath.Num() - 1; ++i)
 	{
-		bFindEntry = true;
+		NewAction->AncestorItems.Emplace(InItemPath[i]);
 	}
+
+	return NewAction;
 }
 
-bool UGuideListEntryAsyncAction::Tick(float DeltaSeconds)
+bool UGuideListEntryAsyncAction::FindTreeItemPath(UTreeView* InTreeView, TFunctionRef<bool(UObject*)> InPredicate, OUT TArray<UObject*>& OutItemPath)
 {
-	if (Timeout > 0.f && (FPlatformTime::Seconds() - StartTime) >= Timeout)
+	OutItemPath.Reset();
+
+	if (nullptr == InTreeView)
 	{
-		Fail();
 		return false;
 	}
 
-	if (bFindEntry)
+	TSet<UObject*> Visited;
+	for (UObject* RootItem : InTreeView->GetListItems())
 	{
-		UUserWidget* Widget = ListViewPtr->GetEntryWidgetFromItem(ItemPtr);
-		if (Widget && false == Widget->TakeWidget()->NeedsPrepass())
+		if (true == GuideListEntryAsyncAction::FindTreeItemPath(InTreeView, RootItem, InPredicate, Visited, OUT OutItemPath))
 		{
-			Success(Widget);
-			return false;
+			return true;
 		}
 	}
 
-	return true;
+	return false;
+}
+
+void UGuideListEntryAsyncAction::Activate()
+{
+	TWeakObjectPtr<UGuideListEntryAsyncAction> WeakThis(this);
+
+	WaitHandle = FGuideListEntryWait::Start(ListViewPtr, ItemPtr, AncestorItems, Timeout, [WeakThis](UUserWidget* InEntryWidget)
+		{
+			if (false == WeakThis.IsValid())
+			{
+				return;
+			}
+
+			if (nullptr != InEntryWidget)
+			{
+				WeakThis->Success(InEntryWidget);
+			}
+
+			else
+			{
+				WeakThis->Fail();
+			}
+		});
+}
+
+void UGuideListEntryAsyncAction::SetReadyToDestroy()
+{
+	WaitHandle.Cancel();
+
+	Super::SetReadyToDestroy();
 }
 
 void UGuideListEntryAsyncAction::Success(UUserWidget* EntryWidget)
@@ -101,7 +134,6 @@ void UGuideListEntryAsyncAction::Success(UUserWidget* EntryWidget)
 	OnReadyNative.Broadcast(WorldContext, EntryWidget);
 	OnReady.Broadcast(WorldContext, EntryWidget);
 
-	Clear();
 	SetReadyToDestroy();
 }
 
@@ -110,16 +142,5 @@ void UGuideListEntryAsyncAction::Fail()
 	OnFailedNative.Broadcast();
 	OnFailed.Broadcast();
 
-	Clear();
 	SetReadyToDestroy();
 }
-
-void UGuideListEntryAsyncAction::Clear()
-{
-	bFindEntry = false;
-
-	if (ListViewPtr)
-	{
-		ListViewPtr->OnItemScrolledIntoView().RemoveAll(this);
-	}
-}
\ No newline at end of file
@@ -4,11 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintAsyncActionBase.h"
-#include "Runtime/Launch/Resources/Version.h"
+#include "GuideListEntryWait.h"
 
 #include "GuideListEntryAsyncAction.generated.h"
 
 class UListView;
+class UTreeView;
 class UUserWidget;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnListEntryReadyEvent, UObject*, InWorldContextObject, UUserWidget*, EntryWidget);
@@ -17,6 +18,9 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnListEntryFailedEvent);
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnListEntryReadyNativeEvent, UObject*, UUserWidget*);
 DECLARE_MULTICAST_DELEGATE(FOnListEntryFailedNativeEvent);
 
+/**
+ * Blueprint node over FGuideListEntryWait. Native code should start the wait directly, without this object.
+ */
 UCLASS()
 class GUIDEMASKUI_API UGuideListEntryAsyncAction : public UBlueprintAsyncActionBase
 {
@@ -40,16 +44,23 @@ public:
 		UObject* InListItem, 
 		float InTimeout);
 
+	/** InItemPath goes from a root item of the tree to the target item. Every ancestor is expanded before the scroll. */
+	UFUNCTION(BlueprintCallable, Category = "Guide", meta = (BlueprintInternalUseOnly = "true", WorldContext = "InWorldContextObject", DisplayName = "Wait Guide Tree Entry"))
+	static UGuideListEntryAsyncAction* CreateForTree(UObject* InWorldContextObject,
+		UTreeView* InTreeView,
+		const TArray<UObject*>& InItemPath,
+		float InTimeout);
+
+	/** Depth first search through the tree's children, OutItemPath ends with the first item the predicate accepts. */
+	static bool FindTreeItemPath(UTreeView* InTreeView, TFunctionRef<bool(UObject*)> InPredicate, OUT TArray<UObject*>& OutItemPath);
+
 	virtual void Activate() override;
 
-private:
-	void HandleItemScrolledIntoView(UObject* Item, UUserWidget& EntryWidget);
+	virtual void SetReadyToDestroy() override;
 
 private:
-	bool Tick(float DeltaSeconds);
 	void Success(UUserWidget* EntryWidget);
 	void Fail();
-	void Clear();
 	
 private:
 	UPROPERTY()
@@ -61,16 +72,12 @@ private:
 	UPROPERTY()
 	UObject* ItemPtr;
 
-	bool bFindEntry = false;
-
-#if ENGINE_MAJOR_VERSION >= 5
-	FTSTicker::FDelegateHandle TickerHandle;
-#else
-	FDelegateHandle TickerHandle;
-#endif
+	// Tree ancestors of ItemPtr, root first.
+	UPROPERTY()
+	TArray<UObject*> AncestorItems;
 
+	FGuideListEntryWaitHandle WaitHandle;
 
-	double StartTime = 0.0;
 	float Timeout = 3.f;
 
 };
@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideListEntryWait.h"
+
+#include "Components/ListView.h"
+#include "Components/TreeView.h"
+#include "Containers/Ticker.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+
+namespace GuideListEntryWait
+{
+	struct FSlot
+	{
+		TWeakObjectPtr<UListView> ListView;
+		TWeakObjectPtr<UObject> Item;
+
+		FGuideListEntryWait::FOnFinished OnFinished;
+
+		FDelegateHandle ScrolledHandle;
+		FDelegateHandle PostTickHandle;
+
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::FDelegateHandle TimeoutHandle;
+#else
+		FDelegateHandle TimeoutHandle;
+#endif
+
+		// Bumped on every release, tokens of the previous wait stop matching.
+		uint32 Serial = 1;
+		bool bActive = false;
+	};
+
+	TArray<FSlot> Slots;
+	TArray<int32> FreeSlots;
+
+	FSlot* FindSlot(int32 InIndex, uint32 InSerial)
+	{
+		if (false == Slots.IsValidIndex(InIndex))
+		{
+			return nullptr;
+		}
+
+		FSlot& Slot = Slots[InIndex];
+		return true == Slot.bActive && InSerial == Slot.Serial ? &Slot : nullptr;
+	}
+}
+
+
+bool FGuideListEntryWaitHandle::IsPending() const
+{
+	return FGuideListEntryWait::IsPending(*this);
+}
+
+void FGuideListEntryWaitHandle::Cancel()
+{
+	FGuideListEntryWait::Cancel(*this);
+}
+
+FGuideListEntryWaitHandle FGuideListEntryWait::Start(UListView* InListView, UObject* InItem, const TArray<UObject*>& InAncestors, float InTimeout, FOnFinished&& InOnFinished)
+{
+	FGuideListEntryWaitHandle Handle;
+
+	UObject* RootItem = 0 < InAncestors.Num() ? InAncestors[0] : InItem;
+	if (nullptr == InListView || nullptr == InItem || false == InListView->GetListItems().Contains(RootItem))
+	{
+		if (InOnFinished)
+		{
+			InOnFinished(nullptr);
+		}
+
+		return Handle;
+	}
+
+	if (UTreeView* TreeView = Cast<UTreeView>(InListView))
+	{
+		// The tree relinearizes once on its next tick, the scroll below is resolved right after in the same tick.
+		for (UObject* Ancestor : InAncestors)
+		{
+			TreeView->SetItemExpansion(Ancestor, true);
+		}
+	}
+
+	if (UUserWidget* EntryWidget = InListView->GetEntryWidgetFromItem(InItem))
+	{
+		if (InOnFinished)
+		{
+			InOnFinished(EntryWidget);
+		}
+
+		return Handle;
+	}
+
+	using namespace GuideListEntryWait;
+
+	const int32 Index = 0 < FreeSlots.Num() ? FreeSlots.Pop() : Slots.AddDefaulted();
+
+	FSlot& Slot = Slots[Index];
+	Slot.ListView = InListView;
+	Slot.Item = InItem;
+	Slot.OnFinished = MoveTemp(InOnFinished);
+	Slot.bActive = true;
+
+	Handle.Index = Index;
+	Handle.Serial = Slot.Serial;
+
+	Slot.ScrolledHandle = InListView->OnItemScrolledIntoView().AddStatic(&FGuideListEntryWait::HandleItemScrolledIntoView, Index, Slot.Serial);
+	InListView->RequestScrollItemIntoView(InItem);
+
+#if ENGINE_MAJOR_VERSION >= 5
+	Slot.TimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateStatic(&FGuideListEntryWait::HandleTimeout, Index, Slot.Serial), FMath::Max(0.5f, InTimeout));
+#else
+	Slot.TimeoutHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateStatic(&FGuideListEntryWait::HandleTimeout, Index, Slot.Serial), FMath::Max(0.5f, InTimeout));
+#endif
+
+	return Handle;
+}
+
+bool FGuideListEntryWait::IsPending(const FGuideListEntryWaitHandle& InHandle)
+{
+	return nullptr != GuideListEntryWait::FindSlot(InHandle.Index, InHandle.Serial);
+}
+
+void FGuideListEntryWait::Cancel(const FGuideListEntryWaitHandle& InHandle)
+{
+	if (nullptr != GuideListEntryWait::FindSlot(InHandle.Index, InHandle.Serial))
+	{
+		Release(InHandle.Index);
+	}
+}
+
+void FGuideListEntryWait::HandleItemScrolledIntoView(UObject* InItem, UUserWidget& InEntryWidget, int32 InIndex, uint32 InSerial)
+{
+	GuideListEntryWait::FSlot* Slot = GuideListEntryWait::FindSlot(InIndex, InSerial);
+	if (nullptr == Slot || InItem != Slot->Item.Get() || Slot->PostTickHandle.IsValid())
+	{
+		return;
+	}
+
+	// The entry is arranged but has no painted geometry yet, it has after this frame's draw.
+	if (FSlateApplication::IsInitialized())
+	{
+		Slot->PostTickHandle = FSlateApplication::Get().OnPostTick().AddStatic(&FGuideListEntryWait::HandlePostTick, InIndex, InSerial);
+	}
+
+	else
+	{
+		Finish(InIndex, InSerial, &InEntryWidget);
+	}
+}
+
+void FGuideListEntryWait::HandlePostTick(float DeltaTime, int32 InIndex, uint32 InSerial)
+{
+	GuideListEntryWait::FSlot* Slot = GuideListEntryWait::FindSlot(InIndex, InSerial);
+	if (nullptr == Slot)
+	{
+		return;
+	}
+
+	UListView* ListView = Slot->ListView.Get();
+	UObject* Item = Slot->Item.Get();
+
+	Finish(InIndex, InSerial, nullptr != ListView && nullptr != Item ? ListView->GetEntryWidgetFromItem(Item) : nullptr);
+}
+
+bool FGuideListEntryWait::HandleTimeout(float DeltaTime, int32 InIndex, uint32 InSerial)
+{
+	if (GuideListEntryWait::FSlot* Slot = GuideListEntryWait::FindSlot(InIndex, InSerial))
+	{
+		// Returning false removes the ticker.
+		Slot->TimeoutHandle.Reset();
+		Finish(InIndex, InSerial, nullptr);
+	}
+
+	return false;
+}
+
+void FGuideListEntryWait::Finish(int32 InIndex, uint32 InSerial, UUserWidget* InEntryWidget)
+{
+	GuideListEntryWait::FSlot* Slot = GuideListEntryWait::FindSlot(InIndex, InSerial);
+	if (nullptr == Slot)
+	{
+		return;
+	}
+
+	// The callback may start new waits and grow the slot array, release first.
+	FOnFinished OnFinished = MoveTemp(Slot->OnFinished);
+	Release(InIndex);
+
+	if (OnFinished)
+	{
+		OnFinished(InEntryWidget);
+	}
+}
+
+void FGuideListEntryWait::Release(int32 InIndex)
+{
+	GuideListEntryWait::FSlot& Slot = GuideListEntryWait::Slots[InIndex];
+
+	if (UListView* ListView = Slot.ListView.Get())
+	{
+		ListView->OnItemScrolledIntoView().Remove(Slot.ScrolledHandle);
+	}
+
+	if (Slot.PostTickHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnPostTick().Remove(Slot.PostTickHandle);
+	}
+
+	if (Slot.TimeoutHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(Slot.TimeoutHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(Slot.TimeoutHandle);
+#endif
+	}
+
+	Slot.ListView.Reset();
+	Slot.Item.Reset();
+	Slot.OnFinished = nullptr;
+	Slot.ScrolledHandle.Reset();
+	Slot.PostTickHandle.Reset();
+	Slot.TimeoutHandle.Reset();
+	Slot.bActive = false;
+	++Slot.Serial;
+
+	GuideListEntryWait::FreeSlots.Emplace(InIndex);
+}
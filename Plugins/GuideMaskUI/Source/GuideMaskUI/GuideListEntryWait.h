@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UListView;
+class UUserWidget;
+
+/**
+ * Token of a running list entry wait. Copies are cheap, a stale token does nothing.
+ */
+struct GUIDEMASKUI_API FGuideListEntryWaitHandle
+{
+public:
+	bool IsPending() const;
+
+	/** Stops the wait and frees its delegates and ticker right away. The callback is not called. */
+	void Cancel();
+
+private:
+	friend class FGuideListEntryWait;
+
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+};
+
+
+/**
+ * Waits for the entry widget of a list, tile or tree view item without creating a UObject.
+ * Waits live in a pooled slot array, a slot is reused once its wait finished or was cancelled. Game thread only.
+ */
+class GUIDEMASKUI_API FGuideListEntryWait
+{
+public:
+	/** Receives the entry widget, or nullptr if the wait failed or timed out. */
+	using FOnFinished = TFunction<void(UUserWidget*)>;
+
+	/**
+	 * InAncestors go from a root item of a tree down to the parent of InItem, they are expanded before the scroll.
+	 * The callback may run before Start returns if the entry is already generated.
+	 */
+	static FGuideListEntryWaitHandle Start(UListView* InListView, UObject* InItem, const TArray<UObject*>& InAncestors, float InTimeout, FOnFinished&& InOnFinished);
+
+	static FGuideListEntryWaitHandle Start(UListView* InListView, UObject* InItem, float InTimeout, FOnFinished&& InOnFinished)
+	{
+		return Start(InListView, InItem, TArray<UObject*>(), InTimeout, MoveTemp(InOnFinished));
+	}
+
+private:
+	friend struct FGuideListEntryWaitHandle;
+
+	static bool IsPending(const FGuideListEntryWaitHandle& InHandle);
+	static void Cancel(const FGuideListEntryWaitHandle& InHandle);
+
+	static void HandleItemScrolledIntoView(UObject* InItem, UUserWidget& InEntryWidget, int32 InIndex, uint32 InSerial);
+	static void HandlePostTick(float DeltaTime, int32 InIndex, uint32 InSerial);
+	static bool HandleTimeout(float DeltaTime, int32 InIndex, uint32 InSerial);
+
+	static void Finish(int32 InIndex, uint32 InSerial, UUserWidget* InEntryWidget);
+	static void Release(int32 InIndex);
+};
@@ -0,0 +1,247 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideMaskProjection.h"
+
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "GameFramework/PlayerController.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/WidgetComponent.h"
+#include "SceneView.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+
+
+namespace GuideMaskProjection
+{
+	// Game thread only. One entry per local player, refreshed once per frame.
+	TMap<TWeakObjectPtr<const ULocalPlayer>, FGuideViewProjection> CachedProjections;
+
+	// Root user widget -> widget component drawing it. Saves the object iteration on the next guide of the same panel.
+	TMap<TWeakObjectPtr<const UUserWidget>, TWeakObjectPtr<UWidgetComponent>> CachedHostComponents;
+
+	const FName VirtualWindowType(TEXT("SVirtualWindow"));
+
+	const UUserWidget* GetRootUserWidget(const UWidget* InWidget)
+	{
+		const UUserWidget* Root = Cast<UUserWidget>(InWidget);
+
+		// Widget -> WidgetTree -> UserWidget, up to the widget that isn't inside another one.
+		for (const UUserWidget* Outer = InWidget->GetTypedOuter<UUserWidget>(); nullptr != Outer; Outer = Outer->GetTypedOuter<UUserWidget>())
+		{
+			Root = Outer;
+		}
+
+		return Root;
+	}
+
+	// A world space widget component draws its widget in an SVirtualWindow, everything else hangs off the game window.
+	bool IsInVirtualWindow(const UUserWidget* InRoot)
+	{
+		TSharedPtr<SWidget> Current = InRoot->GetCachedWidget();
+		if (false == Current.IsValid())
+		{
+			return false;
+		}
+
+		for (TSharedPtr<SWidget> Parent = Current->GetParentWidget(); Parent.IsValid(); Parent = Parent->GetParentWidget())
+		{
+			Current = Parent;
+		}
+
+		return VirtualWindowType == Current->GetType();
+	}
+}
+
+
+bool FGuideViewProjection::Get(const APlayerController* InPlayerController, FGuideViewProjection& OutProjection)
+{
+	const ULocalPlayer* LocalPlayer = nullptr != InPlayerController ? InPlayerController->GetLocalPlayer() : nullptr;
+	if (nullptr == LocalPlayer || nullptr == LocalPlayer->ViewportClient || nullptr == LocalPlayer->ViewportClient->Viewport)
+	{
+		return false;
+	}
+
+	FGuideViewProjection& Cached = GuideMaskProjection::CachedProjections.FindOrAdd(LocalPlayer);
+	if (0 != Cached.FrameNumber && GFrameCounter == Cached.FrameNumber)
+	{
+		OutProjection = Cached;
+		return true;
+	}
+
+	FSceneViewProjectionData ProjectionData;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	if (false == LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
+#else
+	if (false == LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, eSSP_FULL, ProjectionData))
+#endif
+	{
+		return false;
+	}
+
+	Cached.ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+	Cached.ViewRect = ProjectionData.GetConstrainedViewRect();
+	Cached.RegionOrigin = ProjectionData.GetViewRect().Min;
+	Cached.ViewportScale = FMath::Max(UWidgetLayoutLibrary::GetViewportScale(InPlayerController), KINDA_SMALL_NUMBER);
+	Cached.FrameNumber = GFrameCounter;
+
+	// Drop players that went away.
+	for (auto Itr = GuideMaskProjection::CachedProjections.CreateIterator(); Itr; ++Itr)
+	{
+		if (false == Itr.Key().IsValid())
+		{
+			Itr.RemoveCurrent();
+		}
+	}
+
+	OutProjection = GuideMaskProjection::CachedProjections.FindChecked(LocalPlayer);
+	return true;
+}
+
+bool FGuideViewProjection::ProjectPoints(TArrayView<const FVector> InPoints, FVector2D& OutPosition, FVector2D& OutSize) const
+{
+	if (0 == InPoints.Num())
+	{
+		return false;
+	}
+
+	FVector2D Min(TNumericLimits<float>::Max(), TNumericLimits<float>::Max());
+	FVector2D Max(-TNumericLimits<float>::Max(), -TNumericLimits<float>::Max());
+
+	for (const FVector& Point : InPoints)
+	{
+		const FVector4 Result = ViewProjectionMatrix.TransformFVector4(FVector4(Point, 1.f));
+		if (Result.W <= 0.f)
+		{
+			return false;
+		}
+
+		const float NormalizedX = (float)(Result.X / Result.W);
+		const float NormalizedY = (float)(Result.Y / Result.W);
+
+		const FVector2D Pixel(
+			ViewRect.Min.X + (0.5f + NormalizedX * 0.5f) * ViewRect.Width(),
+			ViewRect.Min.Y + (0.5f - NormalizedY * 0.5f) * ViewRect.Height());
+
+		Min = FVector2D(FMath::Min(Min.X, Pixel.X), FMath::Min(Min.Y, Pixel.Y));
+		Max = FVector2D(FMath::Max(Max.X, Pixel.X), FMath::Max(Max.Y, Pixel.Y));
+	}
+
+	// Viewport pixels to the player's region in widget (DPI scaled) units, the space of its guide layers.
+	OutPosition = (Min - FVector2D(RegionOrigin)) / ViewportScale;
+	OutSize = (Max - Min) / ViewportScale;
+
+	return true;
+}
+
+bool FGuideViewProjection::ProjectBox(const FBox& InBox, FVector2D& OutPosition, FVector2D& OutSize) const
+{
+	if (false == InBox.IsValid)
+	{
+		return false;
+	}
+
+	FVector Corners[8];
+	InBox.GetVertices(Corners);
+
+	return ProjectPoints(TArrayView<const FVector>(Corners, 8), OutPosition, OutSize);
+}
+
+UWidgetComponent* FGuideWidgetComponentSpace::FindHostComponent(const UWidget* InWidget)
+{
+	if (nullptr == InWidget)
+	{
+		return nullptr;
+	}
+
+	const UUserWidget* Root = GuideMaskProjection::GetRootUserWidget(InWidget);
+	if (nullptr == Root)
+	{
+		return nullptr;
+	}
+
+	// The usual HUD widget, no component can be drawing it and the object iteration below is skipped.
+	if (true == Root->IsInViewport() || false == GuideMaskProjection::IsInVirtualWindow(Root))
+	{
+		return nullptr;
+	}
+
+	UWidgetComponent* Found = nullptr;
+
+	if (const TWeakObjectPtr<UWidgetComponent>* Cached = GuideMaskProjection::CachedHostComponents.Find(Root))
+	{
+		if (Cached->IsValid() && Root == (*Cached)->GetUserWidgetObject())
+		{
+			Found = Cached->Get();
+		}
+
+		else
+		{
+			GuideMaskProjection::CachedHostComponents.Remove(Root);
+		}
+	}
+
+	if (nullptr == Found)
+	{
+		const UWorld* World = Root->GetWorld();
+
+		for (TObjectIterator<UWidgetComponent> Itr; Itr; ++Itr)
+		{
+			if (World == Itr->GetWorld() && Root == Itr->GetUserWidgetObject())
+			{
+				Found = *Itr;
+				GuideMaskProjection::CachedHostComponents.Emplace(Root, Found);
+				break;
+			}
+		}
+	}
+
+	// Screen space components are added to the viewport, the usual widget math holds for them.
+	return nullptr != Found && EWidgetSpace::World == Found->GetWidgetSpace() ? Found : nullptr;
+}
+
+bool FGuideWidgetComponentSpace::GetWorldCorners(const UWidgetComponent* InComponent, const UWidget* InWidget, FVector (&OutCorners)[4])
+{
+	if (nullptr == InComponent || nullptr == InWidget)
+	{
+		return false;
+	}
+
+	const UUserWidget* Root = InComponent->GetUserWidgetObject();
+	if (nullptr == Root)
+	{
+		return false;
+	}
+
+	const FGeometry& RootGeometry = Root->GetTickSpaceGeometry();
+	const FGeometry& WidgetGeometry = InWidget->GetTickSpaceGeometry();
+
+	const FVector2D RootSize = RootGeometry.GetLocalSize();
+	if (RootSize.X <= 0.f || RootSize.Y <= 0.f)
+	{
+		return false;
+	}
+
+	const FVector2D DrawSize = FVector2D(InComponent->GetCurrentDrawSize());
+	const FVector2D Pivot = InComponent->GetPivot();
+	const FTransform& ComponentTransform = InComponent->GetComponentTransform();
+
+	static const FVector2D Coordinates[4] = { FVector2D(0, 0), FVector2D(1, 0), FVector2D(0, 1), FVector2D(1, 1) };
+
+	for (int32 i = 0; i < 4; ++i)
+	{
+		// Corner in the render target, in draw size units.
+		const FVector2D Absolute = WidgetGeometry.LocalToAbsolute(WidgetGeometry.GetLocalSize() * Coordinates[i]);
+		const FVector2D Pixel = RootGeometry.AbsoluteToLocal(Absolute) / RootSize * DrawSize;
+
+		// Inverse of UWidgetComponent::GetLocalHitLocation, the quad faces local +X.
+		const FVector Local(0.f, -(Pixel.X - DrawSize.X * Pivot.X), -(Pixel.Y - DrawSize.Y * Pivot.Y));
+
+		OutCorners[i] = ComponentTransform.TransformPosition(Local);
+	}
+
+	return true;
+}
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class APlayerController;
+class UWidget;
+class UWidgetComponent;
+
+/**
+ * View projection of one player for the current frame, used to place world targets in the widget space of its screen region.
+ * Every guide projecting for the same player in the same frame shares one matrix.
+ */
+struct GUIDEMASKUI_API FGuideViewProjection
+{
+	FMatrix ViewProjectionMatrix = FMatrix::Identity;
+	FIntRect ViewRect;
+
+	// Top left of the player's split-screen region, positions are relative to it.
+	FIntPoint RegionOrigin = FIntPoint::ZeroValue;
+	float ViewportScale = 1.f;
+	uint64 FrameNumber = 0;
+
+	static bool Get(const APlayerController* InPlayerController, FGuideViewProjection& OutProjection);
+
+	/** Screen rect of the points in widget space, relative to the player's screen region. False if any point is behind the camera. */
+	bool ProjectPoints(TArrayView<const FVector> InPoints, FVector2D& OutPosition, FVector2D& OutSize) const;
+	bool ProjectBox(const FBox& InBox, FVector2D& OutPosition, FVector2D& OutSize) const;
+};
+
+/**
+ * Widgets drawn by a world space UWidgetComponent have their geometry in the component's render target, not in the viewport.
+ */
+struct GUIDEMASKUI_API FGuideWidgetComponentSpace
+{
+	/** World space widget component that draws the widget, or nullptr if it is on the viewport. */
+	static UWidgetComponent* FindHostComponent(const UWidget* InWidget);
+
+	/** World positions of the widget's four corners on the component's quad. */
+	static bool GetWorldCorners(const UWidgetComponent* InComponent, const UWidget* InWidget, FVector (&OutCorners)[4]);
+};
@@ -0,0 +1,291 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideMaskRegistrySubsystem.h"
+
+#include "../GuideMaskUI/UI/GuideMaskRegister.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/ActorComponent.h"
+
+
+UGuideMaskRegistrySubsystem* UGuideMaskRegistrySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = nullptr != WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UGameInstance* GameInstance = nullptr != World ? World->GetGameInstance() : nullptr;
+
+	return nullptr != GameInstance ? GameInstance->GetSubsystem<UGuideMaskRegistrySubsystem>() : nullptr;
+}
+
+ULocalPlayer* UGuideMaskRegistrySubsystem::FindLocalPlayer(const UObject* InContext)
+{
+	if (nullptr == InContext)
+	{
+		return nullptr;
+	}
+
+	if (const UWidget* Widget = Cast<UWidget>(InContext))
+	{
+		return Widget->GetOwningLocalPlayer();
+	}
+
+	if (const APlayerController* PlayerController = Cast<APlayerController>(InContext))
+	{
+		return PlayerController->GetLocalPlayer();
+	}
+
+	if (const APawn* Pawn = Cast<APawn>(InContext))
+	{
+		const APlayerController* PlayerController = Cast<APlayerController>(Pawn->GetController());
+		return nullptr != PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	}
+
+	if (const UActorComponent* Component = Cast<UActorComponent>(InContext))
+	{
+		return FindLocalPlayer(Component->GetOwner());
+	}
+
+	// The local player itself, or one of its subsystems.
+	if (ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(const_cast<UObject*>(InContext)))
+	{
+		return LocalPlayer;
+	}
+
+	return InContext->GetTypedOuter<ULocalPlayer>();
+}
+
+ULocalPlayer* UGuideMaskRegistrySubsystem::FindLocalPlayerOrFirst(const UObject* InContext)
+{
+	const UWorld* World = nullptr != InContext ? InContext->GetWorld() : nullptr;
+	if (nullptr == World)
+	{
+		return nullptr;
+	}
+
+	ULocalPlayer* LocalPlayer = FindLocalPlayer(InContext);
+	if (nullptr == LocalPlayer || World != LocalPlayer->GetWorld())
+	{
+		LocalPlayer = World->GetFirstLocalPlayerFromController();
+	}
+
+	return LocalPlayer;
+}
+
+bool UGuideMaskRegistrySubsystem::IsVisibleToPlayer(const UGuideMaskRegister* InRegister, const ULocalPlayer* InPlayer)
+{
+	if (nullptr == InRegister)
+	{
+		return false;
+	}
+
+	const ULocalPlayer* Owner = InRegister->GetOwningLocalPlayer();
+	return nullptr == InPlayer || nullptr == Owner || InPlayer == Owner;
+}
+
+void UGuideMaskRegistrySubsystem::AddRegister(UGuideMaskRegister* InRegister)
+{
+	if (nullptr == InRegister || RegisterPlayers.Contains(TObjectKey<UGuideMaskRegister>(InRegister)))
+	{
+		return;
+	}
+
+	const TObjectKey<ULocalPlayer> PlayerKey(InRegister->GetOwningLocalPlayer());
+	RegisterPlayers.Emplace(TObjectKey<UGuideMaskRegister>(InRegister), PlayerKey);
+
+	FPlayerIndex& Index = PlayerIndices.FindOrAdd(PlayerKey);
+	Index.Registers.Emplace(InRegister);
+
+	for (const auto& Pair : InRegister->GetTagWidgetList())
+	{
+		Index.TagIndex.FindOrAdd(Pair.Key).AddUnique(InRegister);
+	}
+
+	for (const FGameplayTag& GameplayTag : InRegister->GetGameplayTagContainer().GetGameplayTagParents())
+	{
+		Index.GameplayTagIndex.FindOrAdd(GameplayTag).AddUnique(InRegister);
+	}
+
+	OnRegisterAdded.Broadcast(InRegister);
+}
+
+void UGuideMaskRegistrySubsystem::RemoveRegister(UGuideMaskRegister* InRegister)
+{
+	TObjectKey<ULocalPlayer> PlayerKey;
+	if (nullptr == InRegister || false == RegisterPlayers.RemoveAndCopyValue(TObjectKey<UGuideMaskRegister>(InRegister), PlayerKey))
+	{
+		return;
+	}
+
+	if (FPlayerIndex* Index = PlayerIndices.Find(PlayerKey))
+	{
+		Index->Registers.Remove(InRegister);
+
+		for (const auto& Pair : InRegister->GetTagWidgetList())
+		{
+			if (TArray<TWeakObjectPtr<UGuideMaskRegister>>* Found = Index->TagIndex.Find(Pair.Key))
+			{
+				Found->Remove(InRegister);
+
+				if (0 == Found->Num())
+				{
+					Index->TagIndex.Remove(Pair.Key);
+				}
+			}
+		}
+
+		for (const FGameplayTag& GameplayTag : InRegister->GetGameplayTagContainer().GetGameplayTagParents())
+		{
+			if (TArray<TWeakObjectPtr<UGuideMaskRegister>>* Found = Index->GameplayTagIndex.Find(GameplayTag))
+			{
+				Found->Remove(InRegister);
+
+				if (0 == Found->Num())
+				{
+					Index->GameplayTagIndex.Remove(GameplayTag);
+				}
+			}
+		}
+
+		if (0 == Index->Registers.Num())
+		{
+			PlayerIndices.Remove(PlayerKey);
+		}
+	}
+
+	OnRegisterRemoved.Broadcast(InRegister);
+}
+
+UGuideMaskRegister* UGuideMaskRegistrySubsystem::FindRegister(const UWorld* InWorld, const FName& InTag, const ULocalPlayer* InPlayer) const
+{
+	UGuideMaskRegister* Result = nullptr;
+
+	ForEachIndex(InPlayer, [&](const FPlayerIndex& InIndex)
+		{
+			const TArray<TWeakObjectPtr<UGuideMaskRegister>>* Found = InIndex.TagIndex.Find(InTag);
+			if (nullptr == Found)
+			{
+				return false;
+			}
+
+			for (const TWeakObjectPtr<UGuideMaskRegister>& Register : *Found)
+			{
+				if (Register.IsValid() && (nullptr == InWorld || InWorld == Register->GetWorld()))
+				{
+					Result = Register.Get();
+					return true;
+				}
+			}
+
+			return false;
+		});
+
+	return Result;
+}
+
+void UGuideMaskRegistrySubsystem::GetRegisters(const UWorld* InWorld, OUT TArray<UGuideMaskRegister*>& OutRegisters, const ULocalPlayer* InPlayer) const
+{
+	ForEachIndex(InPlayer, [&](const FPlayerIndex& InIndex)
+		{
+			for (const TWeakObjectPtr<UGuideMaskRegister>& Register : InIndex.Registers)
+			{
+				if (Register.IsValid() && (nullptr == InWorld || InWorld == Register->GetWorld()))
+				{
+					OutRegisters.Emplace(Register.Get());
+				}
+			}
+
+			return false;
+		});
+}
+
+UGuideMaskRegister* UGuideMaskRegistrySubsystem::FindRegister(const UWorld* InWorld, const FGameplayTag& InGameplayTag, const ULocalPlayer* InPlayer) const
+{
+	UGuideMaskRegister* Result = nullptr;
+
+	ForEachIndex(InPlayer, [&](const FPlayerIndex& InIndex)
+		{
+			const TArray<TWeakObjectPtr<UGuideMaskRegister>>* Found = InIndex.GameplayTagIndex.Find(InGameplayTag);
+			if (nullptr == Found)
+			{
+				return false;
+			}
+
+			for (const TWeakObjectPtr<UGuideMaskRegister>& Register : *Found)
+			{
+				// Listed under a parent of its own tags too, keep the exact holder.
+				if (Register.IsValid() && (nullptr == InWorld || InWorld == Register->GetWorld()) &&
+					true == Register->GetGameplayTagContainer().HasTagExact(InGameplayTag))
+				{
+					Result = Register.Get();
+					return true;
+				}
+			}
+
+			return false;
+		});
+
+	return Result;
+}
+
+void UGuideMaskRegistrySubsystem::GetMatchingRegisters(const UWorld* InWorld, const FGameplayTag& InParentTag, OUT TArray<UGuideMaskRegister*>& OutRegisters, const ULocalPlayer* InPlayer) const
+{
+	ForEachIndex(InPlayer, [&](const FPlayerIndex& InIndex)
+		{
+			const TArray<TWeakObjectPtr<UGuideMaskRegister>>* Found = InIndex.GameplayTagIndex.Find(InParentTag);
+			if (nullptr == Found)
+			{
+				return false;
+			}
+
+			for (const TWeakObjectPtr<UGuideMaskRegister>& Register : *Found)
+			{
+				if (Register.IsValid() && (nullptr == InWorld || InWorld == Register->GetWorld()))
+				{
+					OutRegisters.Emplace(Register.Get());
+				}
+			}
+
+			return false;
+		});
+}
+
+void UGuideMaskRegistrySubsystem::Deinitialize()
+{
+	PlayerIndices.Reset();
+	RegisterPlayers.Reset();
+
+	Super::Deinitialize();
+}
+
+void UGuideMaskRegistrySubsystem::ForEachIndex(const ULocalPlayer* InPlayer, TFunctionRef<bool(const FPlayerIndex&)> InCallback) const
+{
+	if (nullptr == InPlayer)
+	{
+		for (const auto& Pair : PlayerIndices)
+		{
+			if (true == InCallback(Pair.Value))
+			{
+				return;
+			}
+		}
+
+		return;
+	}
+
+	if (const FPlayerIndex* Own = PlayerIndices.Find(TObjectKey<ULocalPlayer>(InPlayer)))
+	{
+		if (true == InCallback(*Own))
+		{
+			return;
+		}
+	}
+
+	if (const FPlayerIndex* Shared = PlayerIndices.Find(TObjectKey<ULocalPlayer>()))
+	{
+		InCallback(*Shared);
+	}
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
+
+#include "GuideMaskRegistrySubsystem.generated.h"
+
+class UGuideMaskRegister;
+class ULocalPlayer;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGuideRegisterChanged, UGuideMaskRegister*);
+
+/**
+ * Live guide registers of the game instance, indexed by tag.
+ * Registers add themselves when their slate widget is built and leave when it is released, lookups never scan objects.
+ * Each local player has its own index, split-screen players only find the registers on their own screen.
+ * Registers without an owning player are shared by every player.
+ */
+UCLASS()
+class GUIDEMASKUI_API UGuideMaskRegistrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UGuideMaskRegistrySubsystem* Get(const UObject* WorldContextObject);
+
+	/** Local player that owns the object's screen: widgets, player controllers, their pawns and local players. Nullptr if none. */
+	static ULocalPlayer* FindLocalPlayer(const UObject* InContext);
+
+	/** Split-screen: the player whose screen the context is on. Contexts without one, or from another world, use the first player. */
+	static ULocalPlayer* FindLocalPlayerOrFirst(const UObject* InContext);
+
+	void AddRegister(UGuideMaskRegister* InRegister);
+	void RemoveRegister(UGuideMaskRegister* InRegister);
+
+	// A null player searches every player.
+
+	/** First live register of the world that holds the tag. */
+	UGuideMaskRegister* FindRegister(const UWorld* InWorld, const FName& InTag, const ULocalPlayer* InPlayer = nullptr) const;
+	void GetRegisters(const UWorld* InWorld, OUT TArray<UGuideMaskRegister*>& OutRegisters, const ULocalPlayer* InPlayer = nullptr) const;
+
+	/** First live register of the world that maps exactly this gameplay tag. */
+	UGuideMaskRegister* FindRegister(const UWorld* InWorld, const FGameplayTag& InGameplayTag, const ULocalPlayer* InPlayer = nullptr) const;
+
+	/** Registers mapping the tag or any of its children. */
+	void GetMatchingRegisters(const UWorld* InWorld, const FGameplayTag& InParentTag, OUT TArray<UGuideMaskRegister*>& OutRegisters, const ULocalPlayer* InPlayer = nullptr) const;
+
+	/** True if a register is on the player's screen, or on every screen. */
+	static bool IsVisibleToPlayer(const UGuideMaskRegister* InRegister, const ULocalPlayer* InPlayer);
+
+	FOnGuideRegisterChanged OnRegisterAdded;
+	FOnGuideRegisterChanged OnRegisterRemoved;
+
+	virtual void Deinitialize() override;
+
+private:
+	struct FPlayerIndex
+	{
+		TArray<TWeakObjectPtr<UGuideMaskRegister>> Registers;
+		TMap<FName, TArray<TWeakObjectPtr<UGuideMaskRegister>>> TagIndex;
+
+		// A register is listed under each mapped gameplay tag and all of its parents, hierarchical queries are one lookup.
+		TMap<FGameplayTag, TArray<TWeakObjectPtr<UGuideMaskRegister>>> GameplayTagIndex;
+	};
+
+	// The player's own index first, then the shared one. Stops when the callback returns true.
+	void ForEachIndex(const ULocalPlayer* InPlayer, TFunctionRef<bool(const FPlayerIndex&)> InCallback) const;
+
+private:
+	// The null key holds the registers without an owning player.
+	TMap<TObjectKey<ULocalPlayer>, FPlayerIndex> PlayerIndices;
+
+	// Player each register was indexed under, removal must hit the same index even if the owner changed since.
+	TMap<TObjectKey<UGuideMaskRegister>, TObjectKey<ULocalPlayer>> RegisterPlayers;
+};
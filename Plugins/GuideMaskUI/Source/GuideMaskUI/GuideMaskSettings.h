@@ -7,9 +7,21 @@
 
 #include "UI/GuideLayerBase.h"
 #include "UI/GuideBoxBase.h"
+#include "GuideTriggerDefinition.h"
 
 #include "GuideMaskSettings.generated.h"
 
+UENUM()
+enum class EGuidePreemption : uint8
+{
+	// A running guide always finishes first.
+	Never,
+	// A higher priority request replaces the running guide, which is dropped.
+	Drop,
+	// A higher priority request replaces the running guide, which is queued again.
+	Requeue,
+};
+
 /**
  * 
  */
@@ -29,4 +41,49 @@ public:
 
 	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting", meta = (AllowedClasses = "/Script/GuideMaskUI.GuideBoxBase"))
 	TSoftClassPtr<UGuideBoxBase> DefaultBox;
+
+	// Viewport z-order of the overlay hosting every guide layer. Layer z-orders are sorted inside it.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting")
+	int32 HostZOrder = 100;
+
+	// Removed layers kept per player for the next guide, each with its guide box.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting", meta = (ClampMin = "0"))
+	int32 LayerPoolSize = 2;
+
+	// Targets inside a scroll box are scrolled into view before the cutout is placed.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting")
+	bool bScrollIntoView = true;
+
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting", meta = (EditCondition = "bScrollIntoView"))
+	bool bAnimateScroll = false;
+
+	// Seconds without a scroll event after which the scroll counts as settled.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting", meta = (EditCondition = "bScrollIntoView", ClampMin = "0.01"))
+	float ScrollSettleSeconds = 0.1f;
+
+	// Longest wait for the scroll to settle, the guide is shown where the widget is after it. Raise it for long animated scrolls.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting", meta = (EditCondition = "bScrollIntoView", ClampMin = "0.5"))
+	float ScrollTimeoutSeconds = 1.f;
+
+	// Show guides one at a time per player through the guide scheduler.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting")
+	bool bScheduleGuides = true;
+
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting", meta = (EditCondition = "bScheduleGuides"))
+	EGuidePreemption Preemption = EGuidePreemption::Requeue;
+
+	// Save game slot of the guide progress snapshot. Completions in between are appended to a log next to it.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting|Progress")
+	FString ProgressSlotName = TEXT("GuideProgress");
+
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting|Progress")
+	int32 ProgressUserIndex = 0;
+
+	// Log records after which the log is folded into a new snapshot.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting|Progress", meta = (ClampMin = "1"))
+	int32 ProgressCompactThreshold = 256;
+
+	// Registered with the guide trigger subsystem when the game instance starts.
+	UPROPERTY(EditAnywhere, Config, Category = "GuideMaskSetting|Trigger")
+	TArray<TSoftObjectPtr<UGuideTriggerDefinition>> TriggerDefinitions;
 };
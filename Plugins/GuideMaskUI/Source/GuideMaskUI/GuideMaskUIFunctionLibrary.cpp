@@ -3,6 +3,12 @@
 
 #include "GuideMaskUIFunctionLibrary.h"
 #include "GuideListEntryAsyncAction.h"
+#include "GuideListEntryWait.h"
+#include "GuideScrollIntoViewAsyncAction.h"
+#include "GuideLayerHostSubsystem.h"
+#include "GuideMaskRegistrySubsystem.h"
+#include "GuideSchedulerSubsystem.h"
+#include "GuideRequestSubsystem.h"
 
 #include "../GuideMaskUI/UI/GuideMaskRegister.h"
 #include "../GuideMaskUI/UI/GuideLayerBase.h"
@@ -11,186 +17,497 @@
 
 #include "Engine/StreamableManager.h"
 #include "Engine/AssetManager.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
 
 #include "Components/ListView.h"
+#include "Components/TreeView.h"
 #include "Components/DynamicEntryBox.h"
+#include "Components/ScrollBox.h"
 
 //#include "UObject/UObjectGlobals.h"
 
-void UGuideMaskUIFunctionLibrary::ShowGuideWidget(UObject* WorldContextObject, UWidget* InTagWidget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder)
+namespace GuideMaskUIFunctionLibrary
 {
-	if (nullptr == WorldContextObject)
+	UGuideLayerBase* CreateGuideLayer(UObject* WorldContextObject, int InLayerZOrder)
 	{
-		return;
-	}
+		if (nullptr == WorldContextObject)
+		{
+			return nullptr;
+		}
 
-	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
-	if (ensureAlways(Settings) && Settings->DefaultLayer.ToSoftObjectPath().IsValid())
-	{
-		TSubclassOf<UGuideLayerBase> WidgetClass = Settings->DefaultLayer.LoadSynchronous();
-		UGuideLayerBase* GuideLayer = CreateWidget<UGuideLayerBase>(WorldContextObject->GetWorld(), WidgetClass);
-		
-		GuideLayer->AddToViewport(InLayerZOrder);
+		const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+		if (false == ensureAlways(Settings) || false == Settings->DefaultLayer.ToSoftObjectPath().IsValid())
+		{
+			return nullptr;
+		}
+
+		TSubclassOf<UGuideLayerBase> WidgetClass = Settings->DefaultLayer.Get();
+		if (nullptr == WidgetClass)
+		{
+			WidgetClass = Settings->DefaultLayer.LoadSynchronous();
+		}
+
+		UGuideLayerHostSubsystem* Host = UGuideLayerHostSubsystem::Get(WorldContextObject);
+
+		// A pooled layer comes back with the box its last input guide made.
+		UGuideLayerBase* GuideLayer = nullptr != Host ? Host->AcquireLayer(WidgetClass) : nullptr;
+		if (nullptr == GuideLayer)
+		{
+			const ULocalPlayer* LocalPlayer = UGuideMaskRegistrySubsystem::FindLocalPlayer(WorldContextObject);
+			APlayerController* PlayerController = nullptr != LocalPlayer ? LocalPlayer->GetPlayerController(WorldContextObject->GetWorld()) : nullptr;
+
+			GuideLayer = nullptr != PlayerController ?
+				CreateWidget<UGuideLayerBase>(PlayerController, WidgetClass) : CreateWidget<UGuideLayerBase>(WorldContextObject->GetWorld(), WidgetClass);
+		}
 
 		if (ensure(GuideLayer))
 		{
-			GuideLayer->SetGuide(InTagWidget, InActionParam);
+			if (nullptr == Host || false == Host->AddLayer(GuideLayer, InLayerZOrder))
+			{
+				// Only the owner's split-screen region.
+				if (nullptr != GuideLayer->GetOwningPlayer())
+				{
+					GuideLayer->AddToPlayerScreen(InLayerZOrder);
+				}
+
+				else
+				{
+					GuideLayer->AddToViewport(InLayerZOrder);
+				}
+			}
 		}
+
+		return GuideLayer;
 	}
-}
 
-void UGuideMaskUIFunctionLibrary::ShowGuideListEntry(UObject* WorldContextObject, UListView* InTagListView, UObject* InListItem, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, float InAsyncTimeout)
-{
-	if (nullptr == WorldContextObject)
+	UGuideLayerBase* ShowGuide(UObject* WorldContextObject, UObject* InTarget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder)
 	{
-		return;
+		if (nullptr == InTarget)
+		{
+			return nullptr;
+		}
+
+		UGuideLayerBase* GuideLayer = CreateGuideLayer(WorldContextObject, InLayerZOrder);
+		if (nullptr == GuideLayer)
+		{
+			return nullptr;
+		}
+
+		if (UWidget* Widget = Cast<UWidget>(InTarget))
+		{
+			GuideLayer->SetGuide(Widget, InActionParam);
+		}
+
+		else if (AActor* Actor = Cast<AActor>(InTarget))
+		{
+			GuideLayer->SetGuideActor(Actor, InActionParam);
+		}
+
+		else if (USceneComponent* Component = Cast<USceneComponent>(InTarget))
+		{
+			GuideLayer->SetGuideComponent(Component, InActionParam);
+		}
+
+		return GuideLayer;
 	}
 
-	if (UGuideListEntryAsyncAction* AsyncAction = 
-		UGuideListEntryAsyncAction::Create(WorldContextObject->GetWorld(), 
-			InTagListView, 
-			InListItem, 
-			InAsyncTimeout))
+	bool RequestGuide(UObject* WorldContextObject, UObject* InTarget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, int InPriority, const FGuideHandle& InHandle, TFunction<void(UGuideLayerBase*)> InOnPlaced)
 	{
-		AsyncAction->OnReadyNative.AddWeakLambda(WorldContextObject,
-			[InActionParam, InLayerZOrder](UObject* InWorldContextObject, UUserWidget* InEntryWidget)
-			{
-				UGuideMaskUIFunctionLibrary::ShowGuideWidget(InWorldContextObject, InEntryWidget, InActionParam, InLayerZOrder);
-			});
+		const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+		if (nullptr == Settings || false == Settings->bScheduleGuides)
+		{
+			return false;
+		}
 
-		AsyncAction->Activate();
-	}
+		UGuideSchedulerSubsystem* Scheduler = UGuideSchedulerSubsystem::Get(WorldContextObject);
+		if (nullptr == Scheduler)
+		{
+			return false;
+		}
 
-}
+		// Before the request, an identical guide already on screen reports its layer right away.
+		if (UGuideRequestSubsystem* Requests = UGuideRequestSubsystem::Get(WorldContextObject))
+		{
+			Requests->SetScheduled(InHandle, Scheduler, InTarget);
+		}
 
+		return Scheduler->RequestGuide(InTarget, InActionParam, InLayerZOrder, InPriority, MoveTemp(InOnPlaced), InHandle.Id);
+	}
 
-void UGuideMaskUIFunctionLibrary::ShowGuideDynamicWidget(UObject* WorldContextObject, UWidget* InWidget, const TArray<FGuideDynamicWidgetPath>& InPath, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, float InAsyncTimeout)
-{
-	if (nullptr == WorldContextObject)
+	FGuideHandle BeginRequest(UObject* WorldContextObject, UWidget* InScope)
 	{
-		return;
+		UGuideRequestSubsystem* Requests = UGuideRequestSubsystem::Get(WorldContextObject);
+		return nullptr != Requests ? Requests->BeginRequest(InScope) : FGuideHandle();
 	}
 
-#if ENGINE_MAJOR_VERSION >= 5
-	if (true == InPath.IsEmpty())
+	void FailRequest(UObject* WorldContextObject, const FGuideHandle& InHandle)
 	{
-		ShowGuideWidget(WorldContextObject, InWidget, InActionParam, InLayerZOrder);
-		return;
+		if (UGuideRequestSubsystem* Requests = UGuideRequestSubsystem::Get(WorldContextObject))
+		{
+			Requests->Fail(InHandle);
+		}
 	}
-#else
-	if (0 >= InPath.Num())
+
+	// Scheduled or placed right away, the handle follows the layer either way.
+	void SubmitGuide(UObject* WorldContextObject, UObject* InTarget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, int InPriority, const FGuideHandle& InHandle)
 	{
-		ShowGuideWidget(WorldContextObject, InWidget, InActionParam, InLayerZOrder);
-		return;
+		TWeakObjectPtr<UGuideRequestSubsystem> WeakRequests(UGuideRequestSubsystem::Get(WorldContextObject));
+
+		auto OnPlaced = [WeakRequests, InHandle](UGuideLayerBase* InLayer)
+			{
+				if (UGuideRequestSubsystem* Requests = WeakRequests.Get())
+				{
+					Requests->SetLayer(InHandle, InLayer);
+				}
+			};
+
+		if (false == RequestGuide(WorldContextObject, InTarget, InActionParam, InLayerZOrder, InPriority, InHandle, OnPlaced))
+		{
+			UGuideScrollIntoViewAsyncAction* Scroll = UGuideMaskUIFunctionLibrary::PlaceGuide(WorldContextObject, InTarget, InActionParam, InLayerZOrder, OnPlaced);
+
+			if (UGuideRequestSubsystem* Requests = WeakRequests.Get())
+			{
+				Requests->SetScroll(InHandle, Scroll);
+			}
+		}
 	}
-#endif
 
-	TArray<FGuideDynamicWidgetPath> NewPath;
-	for (int i = 1; i < InPath.Num(); ++i)
+	void GetNestedWidgets(UUserWidget* InEntryWidget, OUT TArray<UWidget*>& OutChilds)
 	{
-		NewPath.Emplace(InPath[i]);
+		if (true == InEntryWidget->GetClass()->ImplementsInterface(UEntryGuideIdentifiable::StaticClass()))
+		{
+			IEntryGuideIdentifiable::Execute_GetDesiredNestedWidgets(InEntryWidget, OUT OutChilds);
+		}
+
+		else if (IEntryGuideIdentifiable* Identify = Cast<IEntryGuideIdentifiable>(InEntryWidget))
+		{
+			Identify->GetDesiredNestedWidgets_Implementation(OUT OutChilds);
+		}
 	}
 
-	FGuideDynamicWidgetPath CurrentPath = InPath[0];
-	if (UListView* ListView = Cast<UListView>(InWidget))
+	void ShowDynamicWidget(UObject* WorldContextObject, UWidget* InWidget, const TArray<FGuideDynamicWidgetPath>& InPath, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, float InAsyncTimeout, const FGuideHandle& InHandle)
 	{
-		UObject* const* ListItem = ListView->GetListItems().FindByPredicate([Event = CurrentPath.Predicate](UObject* InItem) -> bool
-			{
-				return true == Event.IsBound() ? Event.Execute(EGuideWidgetPredTarget::ListItem, InItem) : false;
-			});
+		if (0 >= InPath.Num())
+		{
+			SubmitGuide(WorldContextObject, InWidget, InActionParam, InLayerZOrder, 0, InHandle);
+			return;
+		}
+
+		TArray<FGuideDynamicWidgetPath> NewPath;
+		for (int i = 1; i < InPath.Num(); ++i)
+		{
+			NewPath.Emplace(InPath[i]);
+		}
 
-		if (ListItem && *ListItem)
+		FGuideDynamicWidgetPath CurrentPath = InPath[0];
+		if (UListView* ListView = Cast<UListView>(InWidget))
 		{
-			if (UGuideListEntryAsyncAction* AsyncAction =
-				UGuideListEntryAsyncAction::Create(WorldContextObject->GetWorld(),
-					ListView,
-					*ListItem,
-					InAsyncTimeout))
+			auto Predicate = [Event = CurrentPath.Predicate](UObject* InItem) -> bool
+				{
+					return true == Event.IsBound() ? Event.Execute(EGuideWidgetPredTarget::ListItem, InItem) : false;
+				};
+
+			UObject* Item = nullptr;
+			TArray<UObject*> Ancestors;
+
+			// Tile views are list views, trees may hold the item several levels below a root item.
+			if (UTreeView* TreeView = Cast<UTreeView>(ListView))
 			{
-				AsyncAction->OnReadyNative.AddWeakLambda(WorldContextObject,
-					[NewPath, ChildIndex = CurrentPath.NextChildIndex, InActionParam, InLayerZOrder, InAsyncTimeout](UObject* InWorldContextObject, UUserWidget* InEntryWidget)
+				if (true == UGuideListEntryAsyncAction::FindTreeItemPath(TreeView, Predicate, OUT Ancestors))
+				{
+					Item = Ancestors.Pop();
+				}
+			}
+
+			else
+			{
+				UObject* const* ListItem = ListView->GetListItems().FindByPredicate(Predicate);
+				Item = ListItem ? *ListItem : nullptr;
+			}
+
+			if (nullptr == Item)
+			{
+				FailRequest(WorldContextObject, InHandle);
+				return;
+			}
+
+			TWeakObjectPtr<UObject> WeakContext(WorldContextObject);
+			TWeakObjectPtr<UListView> WeakListView(ListView);
+
+			const FGuideListEntryWaitHandle Wait = FGuideListEntryWait::Start(ListView, Item, Ancestors, InAsyncTimeout,
+				[WeakContext, WeakListView, NewPath, ChildIndex = CurrentPath.NextChildIndex, InActionParam, InLayerZOrder, InAsyncTimeout, InHandle](UUserWidget* InEntryWidget)
+				{
+					UObject* InWorldContextObject = WeakContext.Get();
+					if (nullptr == InWorldContextObject)
 					{
-						if (nullptr == InEntryWidget)
-						{
-							return;
-						}
+						return;
+					}
 
-						TArray<UWidget*> Childs;
-						if (true == InEntryWidget->GetClass()->ImplementsInterface(UEntryGuideIdentifiable::StaticClass()))
+					// Entry never showed up, guide the whole list instead.
+					if (nullptr == InEntryWidget)
+					{
+						if (WeakListView.IsValid())
 						{
-							IEntryGuideIdentifiable::Execute_GetDesiredNestedWidgets(InEntryWidget, OUT Childs);
+							SubmitGuide(InWorldContextObject, WeakListView.Get(), InActionParam, InLayerZOrder, 0, InHandle);
 						}
 
-						else if (IEntryGuideIdentifiable* Identify = Cast<IEntryGuideIdentifiable>(InEntryWidget))
+						else
 						{
-							Identify->GetDesiredNestedWidgets_Implementation(OUT Childs);
+							FailRequest(InWorldContextObject, InHandle);
 						}
 
-						if (false == Childs.IsValidIndex(ChildIndex))
-						{
-							ShowGuideWidget(InWorldContextObject, InEntryWidget, InActionParam, InLayerZOrder);
-						}
+						return;
+					}
 
-						else
-						{
-							ShowGuideDynamicWidget(InWorldContextObject, Childs[ChildIndex], NewPath, InActionParam, InLayerZOrder, InAsyncTimeout);
-						}					
-					});
+					TArray<UWidget*> Childs;
+					GetNestedWidgets(InEntryWidget, OUT Childs);
+
+					if (false == Childs.IsValidIndex(ChildIndex))
+					{
+						SubmitGuide(InWorldContextObject, InEntryWidget, InActionParam, InLayerZOrder, 0, InHandle);
+					}
 
-				AsyncAction->OnFailedNative.AddWeakLambda(WorldContextObject,
-					[WorldContextObject, ListView, InActionParam, InLayerZOrder]()
+					else
 					{
-						ShowGuideWidget(WorldContextObject, ListView, InActionParam, InLayerZOrder);
-					});
+						ShowDynamicWidget(InWorldContextObject, Childs[ChildIndex], NewPath, InActionParam, InLayerZOrder, InAsyncTimeout, InHandle);
+					}
+				});
 
-				AsyncAction->Activate();
+			if (UGuideRequestSubsystem* Requests = UGuideRequestSubsystem::Get(WorldContextObject))
+			{
+				Requests->SetWait(InHandle, Wait);
 			}
 		}
+
+		else if (UDynamicEntryBox* EntryBox = Cast<UDynamicEntryBox>(InWidget))
+		{
+			UUserWidget* const* Entry = EntryBox->GetAllEntries().FindByPredicate([Event = CurrentPath.Predicate](UUserWidget* InEntry)
+				{
+					return true == Event.IsBound() ? Event.Execute(EGuideWidgetPredTarget::EntryWidget, InEntry) : false;
+				});
+
+			UUserWidget* EntryPtr = Entry && *Entry ? *Entry : nullptr;
+
+			if (nullptr != EntryPtr)
+			{
+				TArray<UWidget*> Childs;
+				GetNestedWidgets(EntryPtr, OUT Childs);
+
+				if (false == Childs.IsValidIndex(CurrentPath.NextChildIndex))
+				{
+					SubmitGuide(WorldContextObject, EntryPtr, InActionParam, InLayerZOrder, 0, InHandle);
+				}
+
+				else
+				{
+					ShowDynamicWidget(WorldContextObject, Childs[CurrentPath.NextChildIndex], NewPath, InActionParam, InLayerZOrder, InAsyncTimeout, InHandle);
+				}
+			}
+
+			else
+			{
+				SubmitGuide(WorldContextObject, EntryBox, InActionParam, InLayerZOrder, 0, InHandle);
+			}
+		}
+
+		else
+		{
+			SubmitGuide(WorldContextObject, InWidget, InActionParam, InLayerZOrder, 0, InHandle);
+		}
 	}
+}
 
-	else if (UDynamicEntryBox* EntryBox = Cast<UDynamicEntryBox>(InWidget))
+
+UGuideScrollIntoViewAsyncAction* UGuideMaskUIFunctionLibrary::PlaceGuide(UObject* WorldContextObject, UObject* InTarget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, TFunction<void(UGuideLayerBase*)> InOnPlaced)
+{
+	UWidget* Widget = Cast<UWidget>(InTarget);
+
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+
+	TArray<UScrollBox*> ScrollBoxes;
+	if (nullptr != Widget && nullptr != Settings && true == Settings->bScrollIntoView)
 	{
-		UUserWidget* const* Entry = EntryBox->GetAllEntries().FindByPredicate([Event = CurrentPath.Predicate](UUserWidget* InEntry)
-			{
-				return true == Event.IsBound() ? Event.Execute(EGuideWidgetPredTarget::EntryWidget, InEntry) : false;
-			});
+		UGuideScrollIntoViewAsyncAction::GetScrollableAncestors(Widget, OUT ScrollBoxes);
+	}
+
+	UGuideScrollIntoViewAsyncAction* AsyncAction = nullptr != WorldContextObject && 0 < ScrollBoxes.Num() ?
+		UGuideScrollIntoViewAsyncAction::Create(WorldContextObject->GetWorld(), Widget, Settings->bAnimateScroll, Settings->ScrollTimeoutSeconds) : nullptr;
+
+	if (nullptr == AsyncAction)
+	{
+		UGuideLayerBase* GuideLayer = GuideMaskUIFunctionLibrary::ShowGuide(WorldContextObject, InTarget, InActionParam, InLayerZOrder);
+		if (InOnPlaced)
+		{
+			InOnPlaced(GuideLayer);
+		}
+
+		return nullptr;
+	}
 
-		UUserWidget* EntryPtr = Entry && *Entry ? *Entry : nullptr;
-		
-		if (nullptr != EntryPtr)
+	// Ready or not, the guide is shown where the widget ended up.
+	// Bound strongly, the caller must hear back even if the context went away during the scroll.
+	auto OnScrolled = [WeakContext = TWeakObjectPtr<UObject>(WorldContextObject), Target = TWeakObjectPtr<UWidget>(Widget), InActionParam, InLayerZOrder, InOnPlaced]()
 		{
-			TArray<UWidget*> Childs;
-			if (true == EntryPtr->GetClass()->ImplementsInterface(UEntryGuideIdentifiable::StaticClass()))
+			UGuideLayerBase* GuideLayer = WeakContext.IsValid() && Target.IsValid() ?
+				GuideMaskUIFunctionLibrary::ShowGuide(WeakContext.Get(), Target.Get(), InActionParam, InLayerZOrder) : nullptr;
+
+			if (InOnPlaced)
 			{
-				IEntryGuideIdentifiable::Execute_GetDesiredNestedWidgets(EntryPtr, OUT Childs);
+				InOnPlaced(GuideLayer);
 			}
+		};
+
+	AsyncAction->OnReadyNative.AddLambda([OnScrolled](UObject*, UWidget*) { OnScrolled(); });
+	AsyncAction->OnFailedNative.AddLambda(OnScrolled);
+
+	AsyncAction->Activate();
+
+	return AsyncAction;
+}
+
+FGuideHandle UGuideMaskUIFunctionLibrary::ShowGuideWidget(UObject* WorldContextObject, UWidget* InTagWidget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, int InPriority)
+{
+	if (nullptr == WorldContextObject || nullptr == InTagWidget)
+	{
+		return FGuideHandle();
+	}
+
+	const FGuideHandle Handle = GuideMaskUIFunctionLibrary::BeginRequest(WorldContextObject, InTagWidget);
+	GuideMaskUIFunctionLibrary::SubmitGuide(WorldContextObject, InTagWidget, InActionParam, InLayerZOrder, InPriority, Handle);
+
+	return Handle;
+}
+
+FGuideHandle UGuideMaskUIFunctionLibrary::ShowGuideActor(UObject* WorldContextObject, AActor* InActor, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, int InPriority)
+{
+	if (nullptr == WorldContextObject || nullptr == InActor)
+	{
+		return FGuideHandle();
+	}
+
+	const FGuideHandle Handle = GuideMaskUIFunctionLibrary::BeginRequest(WorldContextObject, nullptr);
+	GuideMaskUIFunctionLibrary::SubmitGuide(WorldContextObject, InActor, InActionParam, InLayerZOrder, InPriority, Handle);
+
+	return Handle;
+}
+
+FGuideHandle UGuideMaskUIFunctionLibrary::ShowGuideComponent(UObject* WorldContextObject, USceneComponent* InComponent, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, int InPriority)
+{
+	if (nullptr == WorldContextObject || nullptr == InComponent)
+	{
+		return FGuideHandle();
+	}
+
+	const FGuideHandle Handle = GuideMaskUIFunctionLibrary::BeginRequest(WorldContextObject, nullptr);
+	GuideMaskUIFunctionLibrary::SubmitGuide(WorldContextObject, InComponent, InActionParam, InLayerZOrder, InPriority, Handle);
+
+	return Handle;
+}
 
-			else if (IEntryGuideIdentifiable* Identify = Cast<IEntryGuideIdentifiable>(EntryPtr))
+FGuideHandle UGuideMaskUIFunctionLibrary::ShowGuideListEntry(UObject* WorldContextObject, UListView* InTagListView, UObject* InListItem, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, float InAsyncTimeout)
+{
+	if (nullptr == WorldContextObject)
+	{
+		return FGuideHandle();
+	}
+
+	const FGuideHandle Handle = GuideMaskUIFunctionLibrary::BeginRequest(WorldContextObject, InTagListView);
+	TWeakObjectPtr<UObject> WeakContext(WorldContextObject);
+
+	const FGuideListEntryWaitHandle Wait = FGuideListEntryWait::Start(InTagListView, InListItem, InAsyncTimeout,
+		[WeakContext, InActionParam, InLayerZOrder, Handle](UUserWidget* InEntryWidget)
+		{
+			if (false == WeakContext.IsValid())
 			{
-				Identify->GetDesiredNestedWidgets_Implementation(OUT Childs);
+				return;
 			}
 
-			if (false == Childs.IsValidIndex(CurrentPath.NextChildIndex))
+			if (nullptr != InEntryWidget)
 			{
-				ShowGuideWidget(WorldContextObject, EntryPtr, InActionParam, InLayerZOrder);
+				GuideMaskUIFunctionLibrary::SubmitGuide(WeakContext.Get(), InEntryWidget, InActionParam, InLayerZOrder, 0, Handle);
 			}
 
 			else
 			{
-				ShowGuideDynamicWidget(WorldContextObject, Childs[CurrentPath.NextChildIndex], NewPath, InActionParam, InLayerZOrder, InAsyncTimeout);
+				GuideMaskUIFunctionLibrary::FailRequest(WeakContext.Get(), Handle);
 			}
-		}
+		});
 
-		else
+	if (UGuideRequestSubsystem* Requests = UGuideRequestSubsystem::Get(WorldContextObject))
+	{
+		Requests->SetWait(Handle, Wait);
+	}
+
+	return Handle;
+}
+
+
+FGuideHandle UGuideMaskUIFunctionLibrary::ShowGuideTreeEntry(UObject* WorldContextObject, UTreeView* InTagTreeView, const TArray<UObject*>& InItemPath, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, float InAsyncTimeout)
+{
+	if (nullptr == WorldContextObject || 0 == InItemPath.Num())
+	{
+		return FGuideHandle();
+	}
+
+	TArray<UObject*> Ancestors(InItemPath);
+	UObject* Item = Ancestors.Pop();
+
+	const FGuideHandle Handle = GuideMaskUIFunctionLibrary::BeginRequest(WorldContextObject, InTagTreeView);
+	TWeakObjectPtr<UObject> WeakContext(WorldContextObject);
+
+	const FGuideListEntryWaitHandle Wait = FGuideListEntryWait::Start(InTagTreeView, Item, Ancestors, InAsyncTimeout,
+		[WeakContext, InActionParam, InLayerZOrder, Handle](UUserWidget* InEntryWidget)
 		{
-			ShowGuideWidget(WorldContextObject, EntryBox, InActionParam, InLayerZOrder);
-		}
+			if (false == WeakContext.IsValid())
+			{
+				return;
+			}
+
+			if (nullptr != InEntryWidget)
+			{
+				GuideMaskUIFunctionLibrary::SubmitGuide(WeakContext.Get(), InEntryWidget, InActionParam, InLayerZOrder, 0, Handle);
+			}
+
+			else
+			{
+				GuideMaskUIFunctionLibrary::FailRequest(WeakContext.Get(), Handle);
+			}
+		});
+
+	if (UGuideRequestSubsystem* Requests = UGuideRequestSubsystem::Get(WorldContextObject))
+	{
+		Requests->SetWait(Handle, Wait);
 	}
 
-	else
+	return Handle;
+}
+
+
+FGuideHandle UGuideMaskUIFunctionLibrary::ShowGuideDynamicWidget(UObject* WorldContextObject, UWidget* InWidget, const TArray<FGuideDynamicWidgetPath>& InPath, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, float InAsyncTimeout)
+{
+	if (nullptr == WorldContextObject)
 	{
-		ShowGuideWidget(WorldContextObject, InWidget, InActionParam, InLayerZOrder);
+		return FGuideHandle();
 	}
+
+	// One handle for the whole path, every level waits under it.
+	const FGuideHandle Handle = GuideMaskUIFunctionLibrary::BeginRequest(WorldContextObject, InWidget);
+	GuideMaskUIFunctionLibrary::ShowDynamicWidget(WorldContextObject, InWidget, InPath, InActionParam, InLayerZOrder, InAsyncTimeout, Handle);
+
+	return Handle;
+}
+
+bool UGuideMaskUIFunctionLibrary::CancelGuide(UObject* WorldContextObject, const FGuideHandle& InHandle)
+{
+	UGuideRequestSubsystem* Requests = UGuideRequestSubsystem::Get(WorldContextObject);
+	return nullptr != Requests && Requests->CancelGuide(InHandle);
+}
+
+EGuideRequestState UGuideMaskUIFunctionLibrary::GetGuideState(UObject* WorldContextObject, const FGuideHandle& InHandle)
+{
+	const UGuideRequestSubsystem* Requests = UGuideRequestSubsystem::Get(WorldContextObject);
+	return nullptr != Requests ? Requests->GetGuideState(InHandle) : EGuideRequestState::None;
 }
 
 void UGuideMaskUIFunctionLibrary::GetAllGuideRegisters(UObject* WorldContextObject, TArray<UGuideMaskRegister*>& FoundWidgets)
@@ -208,12 +525,22 @@ void UGuideMaskUIFunctionLibrary::GetAllGuideRegisters(UObject* WorldContextObje
 		return;
 	}
 
+	// Split-screen: only the registers on the context's screen, contexts without a player see every screen.
+	const ULocalPlayer* LocalPlayer = UGuideMaskRegistrySubsystem::FindLocalPlayer(WorldContextObject);
+
+	if (UGuideMaskRegistrySubsystem* Registry = UGuideMaskRegistrySubsystem::Get(World))
+	{
+		Registry->GetRegisters(World, OUT FoundWidgets, LocalPlayer);
+		return;
+	}
+
+	// No game instance (editor preview worlds), scan.
 	for (TObjectIterator<UGuideMaskRegister> Itr; Itr; ++Itr)
 	{
 		UGuideMaskRegister* LiveWidget = *Itr;
 
 		// Skip any widget that's not in the current world context or that is not a child of the class specified.
-		if (LiveWidget->GetWorld() != World)
+		if (LiveWidget->GetWorld() != World || false == UGuideMaskRegistrySubsystem::IsVisibleToPlayer(LiveWidget, LocalPlayer))
 		{
 			continue;
 		}
@@ -234,6 +561,11 @@ UWidget* UGuideMaskUIFunctionLibrary::GetTagWidget(UObject* WorldContextObject,
 
 UGuideMaskRegister* UGuideMaskUIFunctionLibrary::GetRegister(UObject* WorldContextObject, const FName& InTag)
 {
+	if (UGuideMaskRegistrySubsystem* Registry = UGuideMaskRegistrySubsystem::Get(WorldContextObject))
+	{
+		return Registry->FindRegister(WorldContextObject->GetWorld(), InTag, UGuideMaskRegistrySubsystem::FindLocalPlayer(WorldContextObject));
+	}
+
 	TArray<UGuideMaskRegister*> Widgets;
 	GetAllGuideRegisters(WorldContextObject, OUT Widgets);
 
@@ -243,4 +575,59 @@ UGuideMaskRegister* UGuideMaskUIFunctionLibrary::GetRegister(UObject* WorldConte
 		});
 
 	return FoundRegister && *FoundRegister ? *FoundRegister : nullptr;
-}
\ No newline at end of file
+}
+
+UWidget* UGuideMaskUIFunctionLibrary::GetGameplayTagWidget(UObject* WorldContextObject, const FGameplayTag& InGameplayTag)
+{
+	if (false == InGameplayTag.IsValid())
+	{
+		return nullptr;
+	}
+
+	if (UGuideMaskRegistrySubsystem* Registry = UGuideMaskRegistrySubsystem::Get(WorldContextObject))
+	{
+		UGuideMaskRegister* Register = Registry->FindRegister(WorldContextObject->GetWorld(), InGameplayTag, UGuideMaskRegistrySubsystem::FindLocalPlayer(WorldContextObject));
+		return nullptr != Register ? Register->GetGameplayTagWidget(InGameplayTag) : nullptr;
+	}
+
+	TArray<UGuideMaskRegister*> Registers;
+	GetAllGuideRegisters(WorldContextObject, OUT Registers);
+
+	for (UGuideMaskRegister* Register : Registers)
+	{
+		if (UWidget* Widget = nullptr != Register ? Register->GetGameplayTagWidget(InGameplayTag) : nullptr)
+		{
+			return Widget;
+		}
+	}
+
+	return nullptr;
+}
+
+void UGuideMaskUIFunctionLibrary::GetMatchingTagWidgets(UObject* WorldContextObject, const FGameplayTag& InParentTag, TArray<UWidget*>& OutWidgets)
+{
+	if (false == InParentTag.IsValid())
+	{
+		return;
+	}
+
+	TArray<UGuideMaskRegister*> Registers;
+
+	if (UGuideMaskRegistrySubsystem* Registry = UGuideMaskRegistrySubsystem::Get(WorldContextObject))
+	{
+		Registry->GetMatchingRegisters(WorldContextObject->GetWorld(), InParentTag, OUT Registers, UGuideMaskRegistrySubsystem::FindLocalPlayer(WorldContextObject));
+	}
+
+	else
+	{
+		GetAllGuideRegisters(WorldContextObject, OUT Registers);
+	}
+
+	for (UGuideMaskRegister* Register : Registers)
+	{
+		if (nullptr != Register)
+		{
+			Register->GetMatchingTagWidgets(InParentTag, OUT OutWidgets);
+		}
+	}
+}
@@ -6,6 +6,7 @@
 
 #include "../GuideMaskUI/UI/GuideBoxBase.h"
 #include "../GuideMaskUI/UI/GuideMaskRegister.h"
+#include "GuideRequestSubsystem.h"
 
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "GuideMaskUIFunctionLibrary.generated.h"
@@ -39,6 +40,11 @@ public:
 
 class UGuideMaskRegister;
 class UListView;
+class UTreeView;
+class AActor;
+class USceneComponent;
+class UGuideLayerBase;
+class UGuideScrollIntoViewAsyncAction;
 
 UCLASS()
 class GUIDEMASKUI_API UGuideMaskUIFunctionLibrary : public UBlueprintFunctionLibrary
@@ -47,14 +53,43 @@ class GUIDEMASKUI_API UGuideMaskUIFunctionLibrary : public UBlueprintFunctionLib
 	
 	
 public:
+	/**
+	 * Goes through the guide scheduler when it is enabled. Higher priorities are shown first.
+	 * Every Show function returns a handle that cancels the guide, it is cancelled by itself when the target's register is released.
+	 */
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
-	static void ShowGuideWidget(UObject* WorldContextObject, UWidget* InTagWidget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0);
+	static FGuideHandle ShowGuideWidget(UObject* WorldContextObject, UWidget* InTagWidget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0, int InPriority = 0);
 
+	/** Follows the actor's bounds on screen every frame. */
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
-	static void ShowGuideListEntry(UObject* WorldContextObject, UListView* InTagListView, UObject* InListItem, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0, float InAsyncTimeout = 1.f);
+	static FGuideHandle ShowGuideActor(UObject* WorldContextObject, AActor* InActor, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0, int InPriority = 0);
 
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
-	static void ShowGuideDynamicWidget(UObject* WorldContextObject, UWidget* InWidget, const TArray<FGuideDynamicWidgetPath>& InPath, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0, float InAsyncTimeout = 1.f);
+	static FGuideHandle ShowGuideComponent(UObject* WorldContextObject, USceneComponent* InComponent, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0, int InPriority = 0);
+
+	/**
+	 * Shows a widget, actor or scene component guide right away, without going through the scheduler.
+	 * InOnPlaced receives the layer, or nullptr if nothing could be shown.
+	 * Returns the scroll into view the guide waits on, nullptr if it was placed right away.
+	 */
+	static UGuideScrollIntoViewAsyncAction* PlaceGuide(UObject* WorldContextObject, UObject* InTarget, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder, TFunction<void(UGuideLayerBase*)> InOnPlaced = nullptr);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
+	static FGuideHandle ShowGuideListEntry(UObject* WorldContextObject, UListView* InTagListView, UObject* InListItem, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0, float InAsyncTimeout = 1.f);
+
+	/** InItemPath goes from a root item to the target item, collapsed ancestors are expanded first. */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
+	static FGuideHandle ShowGuideTreeEntry(UObject* WorldContextObject, UTreeView* InTagTreeView, const TArray<UObject*>& InItemPath, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0, float InAsyncTimeout = 1.f);
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
+	static FGuideHandle ShowGuideDynamicWidget(UObject* WorldContextObject, UWidget* InWidget, const TArray<FGuideDynamicWidgetPath>& InPath, const FGuideBoxActionParameters& InActionParam, int InLayerZOrder = 0, float InAsyncTimeout = 1.f);
+
+	/** Drops the request wherever it is: waiting for an entry, queued, or on screen. Returns false if it already ended. */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
+	static bool CancelGuide(UObject* WorldContextObject, const FGuideHandle& InHandle);
+
+	UFUNCTION(BlueprintPure, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
+	static EGuideRequestState GetGuideState(UObject* WorldContextObject, const FGuideHandle& InHandle);
 
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "WidgetClass", DynamicOutputParam = "FoundWidgets"))
 	static void GetAllGuideRegisters(UObject* WorldContextObject, TArray<UGuideMaskRegister*>& FoundWidgets);
@@ -65,4 +100,11 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
 	static UGuideMaskRegister* GetRegister(UObject* WorldContextObject, const FName& InTag);
 
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
+	static UWidget* GetGameplayTagWidget(UObject* WorldContextObject, const FGameplayTag& InGameplayTag);
+
+	/** Tag widgets of every live register whose gameplay tag matches InParentTag. */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Guide Mask UI Functions", meta = (WorldContext = "WorldContextObject"))
+	static void GetMatchingTagWidgets(UObject* WorldContextObject, const FGameplayTag& InParentTag, TArray<UWidget*>& OutWidgets);
+
 };
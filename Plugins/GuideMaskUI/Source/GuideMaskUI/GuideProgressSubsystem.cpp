@@ -0,0 +1,367 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideProgressSubsystem.h"
+#include "GuideMaskSettings.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+
+namespace GuideProgress
+{
+	const uint32 LogMagic = 0x4C504D47; // "GMPL"
+	const int32 LogVersion = 1;
+	const int32 BitsPerWord = 32;
+}
+
+
+UGuideProgressSubsystem* UGuideProgressSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = nullptr != WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UGameInstance* GameInstance = nullptr != World ? World->GetGameInstance() : nullptr;
+
+	return nullptr != GameInstance ? GameInstance->GetSubsystem<UGuideProgressSubsystem>() : nullptr;
+}
+
+FGuideStepId UGuideProgressSubsystem::GetStepId(FName InStepName)
+{
+	FGuideStepId StepId;
+
+	if (true == InStepName.IsNone())
+	{
+		return StepId;
+	}
+
+	if (const int32* Found = StepIndices.Find(InStepName))
+	{
+		StepId.Index = *Found;
+		return StepId;
+	}
+
+	StepId.Index = StepNames.Emplace(InStepName);
+	StepIndices.Emplace(InStepName, StepId.Index);
+	Completed.Add(false);
+
+	AppendLog(ELogOp::Define, StepId.Index, InStepName);
+
+	return StepId;
+}
+
+bool UGuideProgressSubsystem::IsGuideCompleted(const FGuideStepId& InStepId) const
+{
+	return InStepId.Index >= 0 && InStepId.Index < Completed.Num() && true == Completed[InStepId.Index];
+}
+
+bool UGuideProgressSubsystem::IsGuideNameCompleted(FName InStepName) const
+{
+	const int32* Found = StepIndices.Find(InStepName);
+	return nullptr != Found && true == Completed[*Found];
+}
+
+void UGuideProgressSubsystem::MarkGuideCompleted(const FGuideStepId& InStepId, bool bInCompleted)
+{
+	if (InStepId.Index < 0 || InStepId.Index >= Completed.Num() || bInCompleted == Completed[InStepId.Index])
+	{
+		return;
+	}
+
+	Completed[InStepId.Index] = bInCompleted;
+
+	AppendLog(true == bInCompleted ? ELogOp::Set : ELogOp::Clear, InStepId.Index);
+}
+
+void UGuideProgressSubsystem::ResetGuideProgress()
+{
+	// Step indices stay, ids resolved before the reset are still valid.
+	Completed.Init(false, StepNames.Num());
+
+	SaveGuideProgress();
+}
+
+void UGuideProgressSubsystem::SaveGuideProgress()
+{
+	CloseLog();
+
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	if (nullptr == Settings)
+	{
+		return;
+	}
+
+	UGuideProgressSaveGame* SaveGame = Cast<UGuideProgressSaveGame>(UGameplayStatics::CreateSaveGameObject(UGuideProgressSaveGame::StaticClass()));
+	if (nullptr == SaveGame)
+	{
+		return;
+	}
+
+	SaveGame->StepNames = StepNames;
+	SaveGame->CompletedWords.Init(0, FMath::DivideAndRoundUp(Completed.Num(), GuideProgress::BitsPerWord));
+
+	for (TConstSetBitIterator<> Itr(Completed); Itr; ++Itr)
+	{
+		const int32 Index = Itr.GetIndex();
+		SaveGame->CompletedWords[Index / GuideProgress::BitsPerWord] |= 1u << (Index % GuideProgress::BitsPerWord);
+	}
+
+	// The log is only dropped once the snapshot holding it is on disk.
+	if (true == UGameplayStatics::SaveGameToSlot(SaveGame, GetSlotName(), Settings->ProgressUserIndex))
+	{
+		IFileManager::Get().Delete(*GetLogPath(), false, false, true);
+		LogRecordCount = 0;
+	}
+}
+
+void UGuideProgressSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Load();
+}
+
+void UGuideProgressSubsystem::Deinitialize()
+{
+	if (0 < LogRecordCount)
+	{
+		SaveGuideProgress();
+	}
+
+	CloseLog();
+
+	Super::Deinitialize();
+}
+
+void UGuideProgressSubsystem::Load()
+{
+	StepNames.Reset();
+	StepIndices.Reset();
+	Completed.Reset();
+	LogRecordCount = 0;
+
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	if (nullptr == Settings)
+	{
+		return;
+	}
+
+	const FString SlotName = GetSlotName();
+
+	if (true == UGameplayStatics::DoesSaveGameExist(SlotName, Settings->ProgressUserIndex))
+	{
+		if (UGuideProgressSaveGame* SaveGame = Cast<UGuideProgressSaveGame>(UGameplayStatics::LoadGameFromSlot(SlotName, Settings->ProgressUserIndex)))
+		{
+			StepNames = SaveGame->StepNames;
+			Completed.Init(false, StepNames.Num());
+
+			for (int32 i = 0; i < StepNames.Num(); ++i)
+			{
+				StepIndices.Emplace(StepNames[i], i);
+
+				const int32 Word = i / GuideProgress::BitsPerWord;
+				if (SaveGame->CompletedWords.IsValidIndex(Word))
+				{
+					Completed[i] = 0 != (SaveGame->CompletedWords[Word] & (1u << (i % GuideProgress::BitsPerWord)));
+				}
+			}
+		}
+	}
+
+	ReplayLog();
+
+	// Fold what the last session appended into a fresh snapshot.
+	if (0 < LogRecordCount)
+	{
+		SaveGuideProgress();
+	}
+}
+
+void UGuideProgressSubsystem::ReplayLog()
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*GetLogPath()));
+	if (false == Reader.IsValid())
+	{
+		return;
+	}
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	*Reader << Magic;
+	*Reader << Version;
+
+	if (GuideProgress::LogMagic != Magic || GuideProgress::LogVersion != Version || true == Reader->IsError())
+	{
+		return;
+	}
+
+	const int64 TotalSize = Reader->TotalSize();
+
+	// A log written against another snapshot would complete the wrong steps, none of it is kept.
+	const int32 SnapshotStepCount = StepNames.Num();
+	const TBitArray<> SnapshotCompleted = Completed;
+
+	auto DiscardLog = [this, SnapshotStepCount, &SnapshotCompleted, &Reader]()
+		{
+			for (int32 i = SnapshotStepCount; i < StepNames.Num(); ++i)
+			{
+				StepIndices.Remove(StepNames[i]);
+			}
+
+			StepNames.SetNum(SnapshotStepCount);
+			Completed = SnapshotCompleted;
+			LogRecordCount = 0;
+
+			Reader.Reset();
+			IFileManager::Get().Delete(*GetLogPath(), false, false, true);
+		};
+
+	// A record cut short by a crash ends the replay, everything before it is kept.
+	while (Reader->Tell() < TotalSize)
+	{
+		uint8 Op = 0;
+		int32 Index = INDEX_NONE;
+		*Reader << Op;
+		*Reader << Index;
+
+		if (true == Reader->IsError())
+		{
+			break;
+		}
+
+		if ((uint8)ELogOp::Define == Op)
+		{
+			FString Name;
+			*Reader << Name;
+
+			if (true == Reader->IsError())
+			{
+				break;
+			}
+
+			const FName StepName(*Name);
+
+			// Already in the snapshot when the log could not be deleted after the last save.
+			if (0 <= Index && Index < StepNames.Num())
+			{
+				if (StepName != StepNames[Index])
+				{
+					DiscardLog();
+					return;
+				}
+
+				++LogRecordCount;
+				continue;
+			}
+
+			if (Index != StepNames.Num() || true == StepIndices.Contains(StepName))
+			{
+				DiscardLog();
+				return;
+			}
+
+			StepNames.Emplace(StepName);
+			StepIndices.Emplace(StepName, Index);
+			Completed.Add(false);
+		}
+
+		else if ((uint8)ELogOp::Set == Op || (uint8)ELogOp::Clear == Op)
+		{
+			if (Index < 0 || Index >= Completed.Num())
+			{
+				break;
+			}
+
+			Completed[Index] = (uint8)ELogOp::Set == Op;
+		}
+
+		else
+		{
+			break;
+		}
+
+		++LogRecordCount;
+	}
+}
+
+void UGuideProgressSubsystem::AppendLog(ELogOp InOp, int32 InIndex, const FName& InName)
+{
+	if (false == LogWriter.IsValid())
+	{
+		const FString LogPath = GetLogPath();
+		const bool bNewFile = IFileManager::Get().FileSize(*LogPath) <= 0;
+
+		LogWriter.Reset(IFileManager::Get().CreateFileWriter(*LogPath, FILEWRITE_Append | FILEWRITE_AllowRead));
+		if (false == LogWriter.IsValid())
+		{
+			// No writable Saved dir (consoles, sandboxed mobile), fall back to a full snapshot through the save system.
+			SaveGuideProgress();
+			return;
+		}
+
+		if (true == bNewFile)
+		{
+			uint32 Magic = GuideProgress::LogMagic;
+			int32 Version = GuideProgress::LogVersion;
+			*LogWriter << Magic;
+			*LogWriter << Version;
+		}
+	}
+
+	uint8 Op = (uint8)InOp;
+	*LogWriter << Op;
+	*LogWriter << InIndex;
+
+	if (ELogOp::Define == InOp)
+	{
+		FString Name = InName.ToString();
+		*LogWriter << Name;
+	}
+
+	LogWriter->Flush();
+	++LogRecordCount;
+
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	if (nullptr != Settings && LogRecordCount >= Settings->ProgressCompactThreshold)
+	{
+		SaveGuideProgress();
+	}
+}
+
+void UGuideProgressSubsystem::CloseLog()
+{
+	if (LogWriter.IsValid())
+	{
+		LogWriter->Close();
+		LogWriter.Reset();
+	}
+}
+
+FString UGuideProgressSubsystem::GetSlotName() const
+{
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	FString SlotName = nullptr != Settings ? Settings->ProgressSlotName : TEXT("GuideProgress");
+
+#if WITH_EDITOR
+#if ENGINE_MAJOR_VERSION >= 5
+	const int32 PIEInstance = UE::GetPlayInEditorID();
+#else
+	const int32 PIEInstance = GPlayInEditorID;
+#endif
+	if (0 < PIEInstance)
+	{
+		SlotName += FString::Printf(TEXT("_PIE%d"), PIEInstance);
+	}
+#endif
+
+	return SlotName;
+}
+
+FString UGuideProgressSubsystem::GetLogPath() const
+{
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	const int32 UserIndex = nullptr != Settings ? Settings->ProgressUserIndex : 0;
+
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), FString::Printf(TEXT("%s_%d.guidelog"), *GetSlotName(), UserIndex));
+}
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "GuideProgressSubsystem.generated.h"
+
+class FArchive;
+
+/**
+ * Dense index of a guide step. Resolve it once with GetStepId, then every query is a bit test.
+ */
+USTRUCT(BlueprintType)
+struct GUIDEMASKUI_API FGuideStepId
+{
+	GENERATED_BODY()
+
+public:
+	bool IsValid() const { return INDEX_NONE != Index; }
+
+	bool operator==(const FGuideStepId& Other) const { return Index == Other.Index; }
+	bool operator!=(const FGuideStepId& Other) const { return Index != Other.Index; }
+
+	friend uint32 GetTypeHash(const FGuideStepId& InId) { return ::GetTypeHash(InId.Index); }
+
+	UPROPERTY()
+	int32 Index = INDEX_NONE;
+};
+
+
+UCLASS()
+class GUIDEMASKUI_API UGuideProgressSaveGame : public USaveGame
+{
+	GENERATED_BODY()
+
+public:
+	// Position is the step index.
+	UPROPERTY()
+	TArray<FName> StepNames;
+
+	// Completion bits, 32 steps per word.
+	UPROPERTY()
+	TArray<uint32> CompletedWords;
+};
+
+
+/**
+ * Completion state of every guide step of the game instance.
+ * Saved as a save game snapshot plus an append-only log, so completing a step only writes a few bytes.
+ */
+UCLASS()
+class GUIDEMASKUI_API UGuideProgressSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UGuideProgressSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Index of the step, added on first use. Indices stay stable across saves. */
+	UFUNCTION(BlueprintCallable, Category = "Guide Progress")
+	FGuideStepId GetStepId(FName InStepName);
+
+	UFUNCTION(BlueprintPure, Category = "Guide Progress")
+	bool IsGuideCompleted(const FGuideStepId& InStepId) const;
+
+	/** Same as IsGuideCompleted, with one name lookup. Unknown names are not completed. */
+	UFUNCTION(BlueprintPure, Category = "Guide Progress")
+	bool IsGuideNameCompleted(FName InStepName) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Guide Progress")
+	void MarkGuideCompleted(const FGuideStepId& InStepId, bool bInCompleted = true);
+
+	UFUNCTION(BlueprintCallable, Category = "Guide Progress")
+	void ResetGuideProgress();
+
+	/** Writes a new snapshot and empties the log. */
+	UFUNCTION(BlueprintCallable, Category = "Guide Progress")
+	void SaveGuideProgress();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	enum class ELogOp : uint8
+	{
+		Define,
+		Set,
+		Clear,
+	};
+
+	void Load();
+	void ReplayLog();
+	void AppendLog(ELogOp InOp, int32 InIndex, const FName& InName = NAME_None);
+	void CloseLog();
+
+	// Settings slot name. Multi-client PIE runs in one process, so in the editor every instance gets its own slot.
+	FString GetSlotName() const;
+
+	// The log is a plain file under Saved/SaveGames, which only desktop platforms can write.
+	// Elsewhere the log can't be opened and every change is saved as a snapshot instead.
+	FString GetLogPath() const;
+
+private:
+	TArray<FName> StepNames;
+	TMap<FName, int32> StepIndices;
+	TBitArray<> Completed;
+
+	TUniquePtr<FArchive> LogWriter;
+	int32 LogRecordCount = 0;
+};
@@ -0,0 +1,308 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideRequestSubsystem.h"
+#include "GuideMaskRegistrySubsystem.h"
+#include "GuideSchedulerSubsystem.h"
+#include "GuideScrollIntoViewAsyncAction.h"
+
+#include "../GuideMaskUI/UI/GuideLayerBase.h"
+#include "../GuideMaskUI/UI/GuideMaskRegister.h"
+
+#include "Blueprint/UserWidget.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+
+namespace GuideRequestSubsystem
+{
+	const int32 MaxEndedRequests = 64;
+}
+
+
+UGuideRequestSubsystem* UGuideRequestSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = nullptr != WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UGameInstance* GameInstance = nullptr != World ? World->GetGameInstance() : nullptr;
+
+	return nullptr != GameInstance ? GameInstance->GetSubsystem<UGuideRequestSubsystem>() : nullptr;
+}
+
+FGuideHandle UGuideRequestSubsystem::BeginRequest(UWidget* InScope)
+{
+	FGuideHandle Handle;
+	Handle.Id = NextId++;
+
+	// Skips 0, the invalid handle, when the counter wraps.
+	if (0 == NextId)
+	{
+		NextId = 1;
+	}
+
+	FRequest& Request = Requests.Emplace(Handle);
+	Request.Register = FindOwningRegister(InScope);
+
+	return Handle;
+}
+
+void UGuideRequestSubsystem::SetWait(const FGuideHandle& InHandle, const FGuideListEntryWaitHandle& InWait)
+{
+	if (FRequest* Request = FindPending(InHandle))
+	{
+		Request->Wait = InWait;
+	}
+}
+
+void UGuideRequestSubsystem::SetScheduled(const FGuideHandle& InHandle, UGuideSchedulerSubsystem* InScheduler, UObject* InTarget)
+{
+	if (FRequest* Request = FindPending(InHandle))
+	{
+		Request->Scheduler = InScheduler;
+		Request->Target = InTarget;
+	}
+}
+
+void UGuideRequestSubsystem::SetScroll(const FGuideHandle& InHandle, UGuideScrollIntoViewAsyncAction* InScroll)
+{
+	if (FRequest* Request = FindPending(InHandle))
+	{
+		Request->Scroll = InScroll;
+	}
+}
+
+void UGuideRequestSubsystem::SetLayer(const FGuideHandle& InHandle, UGuideLayerBase* InLayer)
+{
+	FRequest* Request = Requests.Find(InHandle);
+
+	// Cancelled while a scroll was still settling, the layer showed up anyway.
+	if (nullptr == Request || EGuideRequestState::Cancelled == Request->State)
+	{
+		if (nullptr != InLayer && nullptr != Request)
+		{
+			InLayer->RemoveFromParent();
+		}
+
+		return;
+	}
+
+	if (EGuideRequestState::Pending != Request->State && EGuideRequestState::Active != Request->State)
+	{
+		return;
+	}
+
+	if (nullptr == InLayer || false == InLayer->IsGuideActive())
+	{
+		End(InHandle, *Request, EGuideRequestState::Failed);
+		return;
+	}
+
+	if (Request->Layer.IsValid() && InLayer != Request->Layer.Get())
+	{
+		Request->Layer->OnGuideFinished.RemoveAll(this);
+	}
+
+	Request->State = EGuideRequestState::Active;
+	Request->Layer = InLayer;
+	Request->Wait = FGuideListEntryWaitHandle();
+	Request->Scroll.Reset();
+
+	InLayer->OnGuideFinished.RemoveAll(this);
+	InLayer->OnGuideFinished.AddUObject(this, &UGuideRequestSubsystem::HandleLayerFinished);
+}
+
+void UGuideRequestSubsystem::Fail(const FGuideHandle& InHandle)
+{
+	if (FRequest* Request = FindPending(InHandle))
+	{
+		End(InHandle, *Request, EGuideRequestState::Failed);
+	}
+}
+
+bool UGuideRequestSubsystem::CancelGuide(const FGuideHandle& InHandle)
+{
+	FRequest* Request = Requests.Find(InHandle);
+	if (nullptr == Request || (EGuideRequestState::Pending != Request->State && EGuideRequestState::Active != Request->State))
+	{
+		return false;
+	}
+
+	// Ended first, so the callbacks below see a cancelled request.
+	TWeakObjectPtr<UGuideLayerBase> Layer = Request->Layer;
+	TWeakObjectPtr<UGuideSchedulerSubsystem> Scheduler = Request->Scheduler;
+	TWeakObjectPtr<UObject> Target = Request->Target;
+	FGuideListEntryWaitHandle Wait = Request->Wait;
+	TWeakObjectPtr<UGuideScrollIntoViewAsyncAction> Scroll = Request->Scroll;
+
+	End(InHandle, *Request, EGuideRequestState::Cancelled);
+
+	Wait.Cancel();
+
+	if (Scroll.IsValid())
+	{
+		Scroll->Cancel();
+	}
+
+	// Only this handle's listener, the scheduler stops the placement once nobody waits on it.
+	if (Scheduler.IsValid() && Target.IsValid())
+	{
+		Scheduler->CancelListener(Target.Get(), InHandle.Id);
+	}
+
+	if (Layer.IsValid() && false == IsLayerShared(Layer.Get()))
+	{
+		Layer->RemoveFromParent();
+	}
+
+	return true;
+}
+
+EGuideRequestState UGuideRequestSubsystem::GetGuideState(const FGuideHandle& InHandle) const
+{
+	const FRequest* Request = Requests.Find(InHandle);
+	return nullptr != Request ? Request->State : EGuideRequestState::None;
+}
+
+void UGuideRequestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UGuideMaskRegistrySubsystem* RegistrySubsystem = Collection.InitializeDependency<UGuideMaskRegistrySubsystem>())
+	{
+		Registry = RegistrySubsystem;
+		RegisterRemovedHandle = RegistrySubsystem->OnRegisterRemoved.AddUObject(this, &UGuideRequestSubsystem::HandleRegisterRemoved);
+	}
+}
+
+void UGuideRequestSubsystem::Deinitialize()
+{
+	if (Registry.IsValid())
+	{
+		Registry->OnRegisterRemoved.Remove(RegisterRemovedHandle);
+	}
+
+	Registry.Reset();
+	RegisterRemovedHandle.Reset();
+
+	for (auto& Pair : Requests)
+	{
+		Pair.Value.Wait.Cancel();
+
+		if (Pair.Value.Scroll.IsValid())
+		{
+			Pair.Value.Scroll->Cancel();
+		}
+	}
+
+	Requests.Reset();
+	EndedHandles.Reset();
+
+	Super::Deinitialize();
+}
+
+UGuideRequestSubsystem::FRequest* UGuideRequestSubsystem::FindPending(const FGuideHandle& InHandle)
+{
+	FRequest* Request = Requests.Find(InHandle);
+	return nullptr != Request && EGuideRequestState::Pending == Request->State ? Request : nullptr;
+}
+
+bool UGuideRequestSubsystem::IsLayerShared(const UGuideLayerBase* InLayer) const
+{
+	for (const auto& Pair : Requests)
+	{
+		if (EGuideRequestState::Active == Pair.Value.State && InLayer == Pair.Value.Layer.Get())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UGuideRequestSubsystem::End(const FGuideHandle& InHandle, FRequest& InRequest, EGuideRequestState InState)
+{
+	InRequest.State = InState;
+	InRequest.Scroll.Reset();
+
+	if (InRequest.Layer.IsValid())
+	{
+		InRequest.Layer->OnGuideFinished.RemoveAll(this);
+	}
+
+	EndedHandles.Emplace(InHandle);
+
+	if (EndedHandles.Num() > GuideRequestSubsystem::MaxEndedRequests)
+	{
+		Requests.Remove(EndedHandles[0]);
+		EndedHandles.RemoveAt(0);
+	}
+}
+
+void UGuideRequestSubsystem::HandleLayerFinished(UGuideLayerBase* InLayer)
+{
+	TArray<FGuideHandle> Finished;
+
+	for (auto& Pair : Requests)
+	{
+		FRequest& Request = Pair.Value;
+		if (EGuideRequestState::Active != Request.State || InLayer != Request.Layer.Get())
+		{
+			continue;
+		}
+
+		// Preempted and queued again, it gets a new layer later.
+		if (Request.Scheduler.IsValid() && true == Request.Scheduler->IsQueued(Request.Target.Get()))
+		{
+			InLayer->OnGuideFinished.RemoveAll(this);
+			Request.Layer.Reset();
+			Request.State = EGuideRequestState::Pending;
+			continue;
+		}
+
+		Finished.Emplace(Pair.Key);
+	}
+
+	// Ending may drop old entries from the map.
+	for (const FGuideHandle& Handle : Finished)
+	{
+		if (FRequest* Request = Requests.Find(Handle))
+		{
+			End(Handle, *Request, EGuideRequestState::Finished);
+		}
+	}
+}
+
+void UGuideRequestSubsystem::HandleRegisterRemoved(UGuideMaskRegister* InRegister)
+{
+	TArray<FGuideHandle> Released;
+
+	for (const auto& Pair : Requests)
+	{
+		const EGuideRequestState State = Pair.Value.State;
+		if (InRegister == Pair.Value.Register.Get() && (EGuideRequestState::Pending == State || EGuideRequestState::Active == State))
+		{
+			Released.Emplace(Pair.Key);
+		}
+	}
+
+	for (const FGuideHandle& Handle : Released)
+	{
+		CancelGuide(Handle);
+	}
+}
+
+UGuideMaskRegister* UGuideRequestSubsystem::FindOwningRegister(UWidget* InWidget)
+{
+	// Up the panels, then across to the user widget owning the widget tree.
+	for (UWidget* Current = InWidget; nullptr != Current; )
+	{
+		if (UGuideMaskRegister* Register = Cast<UGuideMaskRegister>(Current))
+		{
+			return Register;
+		}
+
+		UWidget* Parent = Current->GetParent();
+		Current = nullptr != Parent ? Parent : Current->GetTypedOuter<UUserWidget>();
+	}
+
+	return nullptr;
+}
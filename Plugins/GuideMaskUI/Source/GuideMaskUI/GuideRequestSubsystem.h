@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "GuideListEntryWait.h"
+
+#include "GuideRequestSubsystem.generated.h"
+
+class UWidget;
+class UGuideLayerBase;
+class UGuideMaskRegister;
+class UGuideSchedulerSubsystem;
+class UGuideScrollIntoViewAsyncAction;
+class UGuideMaskRegistrySubsystem;
+
+UENUM(BlueprintType)
+enum class EGuideRequestState : uint8
+{
+	// Unknown or expired handle.
+	None,
+	// Waiting for an entry, a scroll or its turn in the scheduler.
+	Pending,
+	Active,
+	Finished,
+	Cancelled,
+	// The target never showed up.
+	Failed,
+};
+
+/**
+ * Handle of a shown or pending guide, returned by the Show functions.
+ */
+USTRUCT(BlueprintType)
+struct GUIDEMASKUI_API FGuideHandle
+{
+	GENERATED_BODY()
+
+public:
+	bool IsValid() const { return 0 != Id; }
+
+	bool operator==(const FGuideHandle& Other) const { return Id == Other.Id; }
+	bool operator!=(const FGuideHandle& Other) const { return Id != Other.Id; }
+
+	friend uint32 GetTypeHash(const FGuideHandle& InHandle) { return ::GetTypeHash(InHandle.Id); }
+
+	UPROPERTY()
+	int32 Id = 0;
+};
+
+
+/**
+ * Tracks every guide request from Show to its end, so it can be cancelled wherever it is.
+ * A request waiting on a widget of a register is cancelled as soon as that register is released.
+ */
+UCLASS()
+class GUIDEMASKUI_API UGuideRequestSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UGuideRequestSubsystem* Get(const UObject* WorldContextObject);
+
+	/** New pending request. InScope ties it to the register holding that widget, if any. */
+	FGuideHandle BeginRequest(UWidget* InScope);
+
+	/** The request now waits on a list entry, the wait is cancelled with it. */
+	void SetWait(const FGuideHandle& InHandle, const FGuideListEntryWaitHandle& InWait);
+
+	/** The request is queued in the scheduler for the target. */
+	void SetScheduled(const FGuideHandle& InHandle, UGuideSchedulerSubsystem* InScheduler, UObject* InTarget);
+
+	/** The request waits on a scroll into view before its layer is placed, the scroll is cancelled with it. */
+	void SetScroll(const FGuideHandle& InHandle, UGuideScrollIntoViewAsyncAction* InScroll);
+
+	/** A layer showed the guide, or nullptr if it could not be shown. */
+	void SetLayer(const FGuideHandle& InHandle, UGuideLayerBase* InLayer);
+
+	void Fail(const FGuideHandle& InHandle);
+
+	/**
+	 * Drops a pending request or removes its layer. Returns false if it already ended.
+	 * Other requests merged into the same scheduled guide keep waiting, and a layer they share stays.
+	 */
+	bool CancelGuide(const FGuideHandle& InHandle);
+
+	EGuideRequestState GetGuideState(const FGuideHandle& InHandle) const;
+
+	bool IsPending(const FGuideHandle& InHandle) const { return EGuideRequestState::Pending == GetGuideState(InHandle); }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FRequest
+	{
+		EGuideRequestState State = EGuideRequestState::Pending;
+
+		TWeakObjectPtr<UGuideMaskRegister> Register;
+		TWeakObjectPtr<UGuideLayerBase> Layer;
+
+		TWeakObjectPtr<UGuideSchedulerSubsystem> Scheduler;
+		TWeakObjectPtr<UObject> Target;
+
+		FGuideListEntryWaitHandle Wait;
+		TWeakObjectPtr<UGuideScrollIntoViewAsyncAction> Scroll;
+	};
+
+	FRequest* FindPending(const FGuideHandle& InHandle);
+	bool IsLayerShared(const UGuideLayerBase* InLayer) const;
+
+	void End(const FGuideHandle& InHandle, FRequest& InRequest, EGuideRequestState InState);
+	void HandleLayerFinished(UGuideLayerBase* InLayer);
+	void HandleRegisterRemoved(UGuideMaskRegister* InRegister);
+
+	static UGuideMaskRegister* FindOwningRegister(UWidget* InWidget);
+
+private:
+	TMap<FGuideHandle, FRequest> Requests;
+
+	// Ended requests stay queryable for a while, oldest first.
+	TArray<FGuideHandle> EndedHandles;
+
+	int32 NextId = 1;
+
+	TWeakObjectPtr<UGuideMaskRegistrySubsystem> Registry;
+	FDelegateHandle RegisterRemovedHandle;
+};
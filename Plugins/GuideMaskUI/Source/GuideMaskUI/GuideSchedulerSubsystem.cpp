@@ -0,0 +1,369 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideSchedulerSubsystem.h"
+#include "GuideMaskUIFunctionLibrary.h"
+#include "GuideMaskRegistrySubsystem.h"
+#include "GuideScrollIntoViewAsyncAction.h"
+
+#include "../GuideMaskUI/UI/GuideLayerBase.h"
+#include "../GuideMaskUI/GuideMaskSettings.h"
+
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+
+
+namespace GuideSchedulerSubsystem
+{
+	// On top of the scroll timeout, a placement that hasn't reported back by then is lost.
+	constexpr float PlacingGraceSeconds = 1.f;
+}
+
+
+UGuideSchedulerSubsystem* UGuideSchedulerSubsystem::Get(const UObject* WorldContextObject)
+{
+	ULocalPlayer* LocalPlayer = UGuideMaskRegistrySubsystem::FindLocalPlayerOrFirst(WorldContextObject);
+	return nullptr != LocalPlayer ? LocalPlayer->GetSubsystem<UGuideSchedulerSubsystem>() : nullptr;
+}
+
+bool UGuideSchedulerSubsystem::RequestGuide(UObject* InTarget, const FGuideBoxActionParameters& InActionParam, int32 InLayerZOrder, int32 InPriority,
+	TFunction<void(UGuideLayerBase*)> InOnPlaced, int32 InListenerId)
+{
+	if (nullptr == InTarget)
+	{
+		return false;
+	}
+
+	// Already on screen.
+	if (true == IsGuideActive() && true == ActiveRequest.IsSameGuide(InTarget, InActionParam.ActionType))
+	{
+		if (InOnPlaced)
+		{
+			if (nullptr != ActiveLayer)
+			{
+				InOnPlaced(ActiveLayer);
+			}
+
+			else
+			{
+				ActiveRequest.AddListener(MoveTemp(InOnPlaced), InListenerId);
+			}
+		}
+
+		return true;
+	}
+
+	// Asked again before it was shown, keep one request with the latest parameters.
+	if (FRequest* Queued = Queue.FindByPredicate([InTarget, &InActionParam](const FRequest& InRequest)
+		{
+			return InRequest.IsSameGuide(InTarget, InActionParam.ActionType);
+		}))
+	{
+		Queued->ActionParam = InActionParam;
+		Queued->LayerZOrder = InLayerZOrder;
+		Queued->AddListener(MoveTemp(InOnPlaced), InListenerId);
+
+		if (InPriority > Queued->Priority)
+		{
+			Queued->Priority = InPriority;
+			Queue.Heapify(FRequestPredicate());
+		}
+
+		return true;
+	}
+
+	FRequest NewRequest;
+	NewRequest.Target = InTarget;
+	NewRequest.ActionParam = InActionParam;
+	NewRequest.LayerZOrder = InLayerZOrder;
+	NewRequest.Priority = InPriority;
+	NewRequest.Sequence = NextSequence++;
+	NewRequest.AddListener(MoveTemp(InOnPlaced), InListenerId);
+
+	Queue.HeapPush(MoveTemp(NewRequest), FRequestPredicate());
+
+	ScheduleFlush();
+	return true;
+}
+
+void UGuideSchedulerSubsystem::CancelListener(const UObject* InTarget, int32 InListenerId)
+{
+	if (nullptr == InTarget || 0 == InListenerId)
+	{
+		return;
+	}
+
+	for (int32 i = Queue.Num() - 1; i >= 0; --i)
+	{
+		if (Queue[i].Target.Get() == InTarget && true == Queue[i].RemoveListener(InListenerId) && 0 == Queue[i].Listeners.Num())
+		{
+			Queue.RemoveAt(i);
+			Queue.Heapify(FRequestPredicate());
+		}
+	}
+
+	if (ActiveRequest.Target.Get() != InTarget || false == ActiveRequest.RemoveListener(InListenerId))
+	{
+		return;
+	}
+
+	// Nobody waits on the placement any more, stop the scroll and let the queue move on.
+	if (true == bPlacing && 0 == ActiveRequest.Listeners.Num())
+	{
+		if (UGuideScrollIntoViewAsyncAction* Scroll = PlacingScroll.Get())
+		{
+			Scroll->Cancel();
+		}
+
+		OnPlaced(nullptr, ActiveRequest.Sequence);
+	}
+}
+
+bool UGuideSchedulerSubsystem::IsQueued(const UObject* InTarget) const
+{
+	return nullptr != InTarget && Queue.ContainsByPredicate([InTarget](const FRequest& InRequest) { return InRequest.Target.Get() == InTarget; });
+}
+
+void UGuideSchedulerSubsystem::Deinitialize()
+{
+	if (FlushHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(FlushHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(FlushHandle);
+#endif
+		FlushHandle.Reset();
+	}
+
+	StopPlacingWatchdog();
+
+	if (UGuideScrollIntoViewAsyncAction* Scroll = PlacingScroll.Get())
+	{
+		Scroll->Cancel();
+	}
+
+	PlacingScroll.Reset();
+
+	Queue.Reset();
+	ReleaseActive(false);
+	bPlacing = false;
+
+	Super::Deinitialize();
+}
+
+void UGuideSchedulerSubsystem::ScheduleFlush()
+{
+	if (FlushHandle.IsValid())
+	{
+		return;
+	}
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FlushHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideSchedulerSubsystem::Flush));
+#else
+	FlushHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideSchedulerSubsystem::Flush));
+#endif
+}
+
+bool UGuideSchedulerSubsystem::Flush(float DeltaTime)
+{
+	FlushHandle.Reset();
+
+	if (0 == Queue.Num() || true == bPlacing)
+	{
+		return false;
+	}
+
+	// One layer per frame, the rest waits for the next tick.
+	if (GFrameCounter == LastPlacedFrame)
+	{
+		ScheduleFlush();
+		return false;
+	}
+
+	if (nullptr != ActiveLayer)
+	{
+		const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+		const EGuidePreemption Preemption = nullptr != Settings ? Settings->Preemption : EGuidePreemption::Never;
+
+		if (EGuidePreemption::Never == Preemption || Queue.HeapTop().Priority <= ActiveRequest.Priority)
+		{
+			return false;
+		}
+
+		// Keeps its sequence, so it comes back before later requests of the same priority.
+		// Queued before the layer goes, so whoever watches the layer can tell it will come back.
+		if (EGuidePreemption::Requeue == Preemption && ActiveRequest.Target.IsValid())
+		{
+			Queue.HeapPush(ActiveRequest, FRequestPredicate());
+		}
+
+		ReleaseActive(true);
+	}
+
+	while (0 < Queue.Num())
+	{
+		FRequest Next;
+		Queue.HeapPop(Next, FRequestPredicate());
+
+		if (Next.Target.IsValid())
+		{
+			Place(Next);
+			break;
+		}
+
+		Next.Notify(nullptr);
+	}
+
+	return false;
+}
+
+void UGuideSchedulerSubsystem::Place(const FRequest& InRequest)
+{
+	ActiveRequest = InRequest;
+	bPlacing = true;
+	LastPlacedFrame = GFrameCounter;
+
+	TWeakObjectPtr<UGuideSchedulerSubsystem> WeakThis(this);
+	const uint64 Sequence = InRequest.Sequence;
+
+	// The queue waits on bPlacing, it must not wait forever on a callback that never comes.
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	const float WatchdogSeconds = (nullptr != Settings ? Settings->ScrollTimeoutSeconds : 1.f) + GuideSchedulerSubsystem::PlacingGraceSeconds;
+
+	StopPlacingWatchdog();
+
+#if ENGINE_MAJOR_VERSION >= 5
+	PlacingTimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideSchedulerSubsystem::OnPlacingTimeout), WatchdogSeconds);
+#else
+	PlacingTimeoutHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideSchedulerSubsystem::OnPlacingTimeout), WatchdogSeconds);
+#endif
+
+	// The queue's own player is the context, so the layer goes to that player's host and screen region
+	// even for actors and widgets that don't lead back to a player.
+	UObject* Target = InRequest.Target.Get();
+	ULocalPlayer* LocalPlayer = GetLocalPlayer();
+	UObject* Context = nullptr != LocalPlayer && nullptr != LocalPlayer->GetWorld() ? static_cast<UObject*>(LocalPlayer) : Target;
+
+	UGuideScrollIntoViewAsyncAction* Scroll = UGuideMaskUIFunctionLibrary::PlaceGuide(Context, Target, InRequest.ActionParam, InRequest.LayerZOrder,
+		[WeakThis, Sequence](UGuideLayerBase* InLayer)
+		{
+			if (UGuideSchedulerSubsystem* Scheduler = WeakThis.Get())
+			{
+				Scheduler->OnPlaced(InLayer, Sequence);
+			}
+		});
+
+	// Placed right away, the callback already ran.
+	if (true == bPlacing && Sequence == ActiveRequest.Sequence)
+	{
+		PlacingScroll = Scroll;
+	}
+}
+
+void UGuideSchedulerSubsystem::OnPlaced(UGuideLayerBase* InLayer, uint64 InSequence)
+{
+	if (false == bPlacing || InSequence != ActiveRequest.Sequence)
+	{
+		// Came in after the watchdog gave up on it, nobody owns the layer.
+		if (nullptr != InLayer && InLayer != ActiveLayer)
+		{
+			InLayer->RemoveFromParent();
+		}
+
+		return;
+	}
+
+	bPlacing = false;
+	StopPlacingWatchdog();
+	PlacingScroll.Reset();
+
+	// Listeners may cancel, which releases the active request, so they are called on a copy.
+	const FRequest Placed = ActiveRequest;
+
+	// Target went away on the way, nothing to wait for.
+	if (nullptr == InLayer || false == InLayer->IsGuideActive())
+	{
+		if (nullptr != InLayer)
+		{
+			InLayer->RemoveFromParent();
+		}
+
+		ActiveRequest = FRequest();
+		ScheduleFlush();
+
+		Placed.Notify(nullptr);
+		return;
+	}
+
+	ActiveLayer = InLayer;
+	ActiveLayer->OnGuideFinished.AddUObject(this, &UGuideSchedulerSubsystem::OnGuideFinished);
+
+	Placed.Notify(InLayer);
+
+	// Something of higher priority may already be waiting.
+	if (0 < Queue.Num())
+	{
+		ScheduleFlush();
+	}
+}
+
+bool UGuideSchedulerSubsystem::OnPlacingTimeout(float DeltaTime)
+{
+	PlacingTimeoutHandle.Reset();
+
+	// Same as a placement without a layer: listeners hear nullptr and the queue moves on.
+	if (true == bPlacing)
+	{
+		OnPlaced(nullptr, ActiveRequest.Sequence);
+	}
+
+	return false;
+}
+
+void UGuideSchedulerSubsystem::StopPlacingWatchdog()
+{
+	if (PlacingTimeoutHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(PlacingTimeoutHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(PlacingTimeoutHandle);
+#endif
+		PlacingTimeoutHandle.Reset();
+	}
+}
+
+void UGuideSchedulerSubsystem::OnGuideFinished(UGuideLayerBase* InLayer)
+{
+	if (InLayer != ActiveLayer)
+	{
+		return;
+	}
+
+	ReleaseActive(false);
+	ScheduleFlush();
+}
+
+void UGuideSchedulerSubsystem::ReleaseActive(bool bInRemoveLayer)
+{
+	UGuideLayerBase* Layer = ActiveLayer;
+
+	ActiveLayer = nullptr;
+	ActiveRequest = FRequest();
+
+	if (nullptr != Layer)
+	{
+		Layer->OnGuideFinished.RemoveAll(this);
+
+		if (true == bInRemoveLayer)
+		{
+			Layer->RemoveFromParent();
+		}
+	}
+}
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#include "../GuideMaskUI/UI/GuideBoxBase.h"
+
+#include "GuideSchedulerSubsystem.generated.h"
+
+class UGuideLayerBase;
+class UGuideScrollIntoViewAsyncAction;
+
+/**
+ * Puts every guide request of a player in one priority queue and shows them one at a time.
+ * Requests of a frame are gathered and handled together on the next ticker tick, identical ones are merged,
+ * and at most one layer is placed per frame.
+ */
+UCLASS()
+class GUIDEMASKUI_API UGuideSchedulerSubsystem : public ULocalPlayerSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UGuideSchedulerSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	 * InTarget is a widget, an actor or a scene component. Returns false if the request could not be queued.
+	 * InOnPlaced receives the layer every time the request is shown, and nullptr if it is dropped before.
+	 * A non zero InListenerId lets the caller take its listener back with CancelListener.
+	 */
+	bool RequestGuide(UObject* InTarget, const FGuideBoxActionParameters& InActionParam, int32 InLayerZOrder = 0, int32 InPriority = 0,
+		TFunction<void(UGuideLayerBase*)> InOnPlaced = nullptr, int32 InListenerId = 0);
+
+	/**
+	 * Drops one listener of the target's request, without calling it. Other callers merged into the request keep waiting.
+	 * A request left without listeners is dropped, and its placement stopped. The running guide is left alone.
+	 */
+	void CancelListener(const UObject* InTarget, int32 InListenerId);
+
+	bool IsQueued(const UObject* InTarget) const;
+
+	bool IsGuideActive() const { return true == bPlacing || nullptr != ActiveLayer; }
+	int32 GetQueuedCount() const { return Queue.Num(); }
+
+	virtual void Deinitialize() override;
+
+private:
+	struct FRequest
+	{
+		TWeakObjectPtr<UObject> Target;
+		FGuideBoxActionParameters ActionParam;
+		int32 LayerZOrder = 0;
+		int32 Priority = 0;
+
+		// Order of arrival, first come first served among equal priorities.
+		uint64 Sequence = 0;
+
+		struct FListener
+		{
+			int32 Id = 0;
+			TFunction<void(UGuideLayerBase*)> Callback;
+		};
+
+		// Callers merged into this request.
+		TArray<FListener> Listeners;
+
+		void AddListener(TFunction<void(UGuideLayerBase*)>&& InCallback, int32 InId)
+		{
+			if (InCallback)
+			{
+				Listeners.Emplace(FListener{ InId, MoveTemp(InCallback) });
+			}
+		}
+
+		void Notify(UGuideLayerBase* InLayer) const
+		{
+			for (const FListener& Listener : Listeners)
+			{
+				Listener.Callback(InLayer);
+			}
+		}
+
+		// True if the listener was found.
+		bool RemoveListener(int32 InId)
+		{
+			return 0 != InId && 0 < Listeners.RemoveAll([InId](const FListener& InListener) { return InId == InListener.Id; });
+		}
+
+		bool IsSameGuide(const UObject* InTarget, EGuideActionType InActionType) const
+		{
+			return Target.Get() == InTarget && ActionParam.ActionType == InActionType;
+		}
+	};
+
+	struct FRequestPredicate
+	{
+		bool operator()(const FRequest& A, const FRequest& B) const
+		{
+			return A.Priority != B.Priority ? A.Priority > B.Priority : A.Sequence < B.Sequence;
+		}
+	};
+
+	void ScheduleFlush();
+	bool Flush(float DeltaTime);
+
+	void Place(const FRequest& InRequest);
+	void OnPlaced(UGuideLayerBase* InLayer, uint64 InSequence);
+	bool OnPlacingTimeout(float DeltaTime);
+	void StopPlacingWatchdog();
+	void OnGuideFinished(UGuideLayerBase* InLayer);
+	void ReleaseActive(bool bInRemoveLayer);
+
+private:
+	TArray<FRequest> Queue;
+
+	FRequest ActiveRequest;
+
+	UPROPERTY(Transient)
+	UGuideLayerBase* ActiveLayer = nullptr;
+
+	// Between Place and the layer showing up, scroll into view may take a few frames.
+	bool bPlacing = false;
+
+	TWeakObjectPtr<UGuideScrollIntoViewAsyncAction> PlacingScroll;
+
+	uint64 NextSequence = 0;
+	uint64 LastPlacedFrame = 0;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle FlushHandle;
+	FTSTicker::FDelegateHandle PlacingTimeoutHandle;
+#else
+	FDelegateHandle FlushHandle;
+	FDelegateHandle PlacingTimeoutHandle;
+#endif
+};
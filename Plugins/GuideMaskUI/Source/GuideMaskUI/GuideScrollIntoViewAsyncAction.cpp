@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideScrollIntoViewAsyncAction.h"
+#include "GuideMaskSettings.h"
+
+#include "Blueprint/UserWidget.h"
+#include "Components/ScrollBox.h"
+
+
+UGuideScrollIntoViewAsyncAction* UGuideScrollIntoViewAsyncAction::Create(UObject* InWorldContextObject, UWidget* InWidget, bool bInAnimateScroll, float InTimeout)
+{
+	UGuideScrollIntoViewAsyncAction* NewAction = NewObject<UGuideScrollIntoViewAsyncAction>();
+	NewAction->WorldContext = InWorldContextObject;
+	NewAction->WidgetPtr = InWidget;
+	NewAction->bAnimateScroll = bInAnimateScroll;
+	NewAction->Timeout = FMath::Max(0.5f, InTimeout);
+
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	NewAction->SettleSeconds = nullptr != Settings ? FMath::Max(0.01f, Settings->ScrollSettleSeconds) : 0.1f;
+
+	// Tickers and the scroll binding only hold the action weakly, the game instance keeps it alive until it finishes.
+	NewAction->RegisterWithGameInstance(InWorldContextObject);
+
+	return NewAction;
+}
+
+void UGuideScrollIntoViewAsyncAction::GetScrollableAncestors(const UWidget* InWidget, OUT TArray<UScrollBox*>& OutScrollBoxes)
+{
+	OutScrollBoxes.Reset();
+
+	const UWidget* Current = InWidget;
+	while (nullptr != Current)
+	{
+		if (UPanelWidget* Parent = Current->GetParent())
+		{
+			if (UScrollBox* ScrollBox = Cast<UScrollBox>(Parent))
+			{
+				OutScrollBoxes.Emplace(ScrollBox);
+			}
+
+			Current = Parent;
+		}
+
+		else
+		{
+			// Root of a widget tree, continue in the user widget that owns it.
+			Current = Current->GetTypedOuter<UUserWidget>();
+		}
+	}
+}
+
+void UGuideScrollIntoViewAsyncAction::Activate()
+{
+	if (nullptr == WidgetPtr)
+	{
+		Fail();
+		return;
+	}
+
+	GetScrollableAncestors(WidgetPtr, OUT ScrollBoxes);
+
+	if (0 == ScrollBoxes.Num() || true == IsInView())
+	{
+		Success();
+		return;
+	}
+
+	for (UScrollBox* ScrollBox : ScrollBoxes)
+	{
+		ScrollBox->OnUserScrolled.AddDynamic(this, &UGuideScrollIntoViewAsyncAction::HandleUserScrolled);
+		ScrollBox->ScrollWidgetIntoView(WidgetPtr, bAnimateScroll, EDescendantScrollDestination::IntoView);
+	}
+
+	RestartSettle();
+
+#if ENGINE_MAJOR_VERSION >= 5
+	TimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideScrollIntoViewAsyncAction::HandleTimeout), Timeout);
+#else
+	TimeoutHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideScrollIntoViewAsyncAction::HandleTimeout), Timeout);
+#endif
+}
+
+void UGuideScrollIntoViewAsyncAction::Cancel()
+{
+	Clear();
+	SetReadyToDestroy();
+}
+
+void UGuideScrollIntoViewAsyncAction::HandleUserScrolled(float InCurrentOffset)
+{
+	RestartSettle();
+}
+
+bool UGuideScrollIntoViewAsyncAction::HandleSettled(float DeltaTime)
+{
+	SettleHandle.Reset();
+
+	// Not in view yet: the next scroll event starts another quiet period, or the timeout ends the wait.
+	if (true == IsInView())
+	{
+		Success();
+	}
+
+	return false;
+}
+
+bool UGuideScrollIntoViewAsyncAction::HandleTimeout(float DeltaTime)
+{
+	TimeoutHandle.Reset();
+	Fail();
+
+	return false;
+}
+
+void UGuideScrollIntoViewAsyncAction::RestartSettle()
+{
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::GetCoreTicker().RemoveTicker(SettleHandle);
+	SettleHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideScrollIntoViewAsyncAction::HandleSettled), SettleSeconds);
+#else
+	FTicker::GetCoreTicker().RemoveTicker(SettleHandle);
+	SettleHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideScrollIntoViewAsyncAction::HandleSettled), SettleSeconds);
+#endif
+}
+
+bool UGuideScrollIntoViewAsyncAction::IsInView() const
+{
+	if (nullptr == WidgetPtr)
+	{
+		return false;
+	}
+
+	const FSlateRect WidgetRect = WidgetPtr->GetTickSpaceGeometry().GetLayoutBoundingRect();
+
+	for (const UScrollBox* ScrollBox : ScrollBoxes)
+	{
+		if (nullptr == ScrollBox)
+		{
+			continue;
+		}
+
+		const FSlateRect BoxRect = ScrollBox->GetTickSpaceGeometry().GetLayoutBoundingRect();
+
+		// One pixel of slack for the rounding of the scroll offset.
+		if (WidgetRect.Left < BoxRect.Left - 1.f || WidgetRect.Top < BoxRect.Top - 1.f ||
+			WidgetRect.Right > BoxRect.Right + 1.f || WidgetRect.Bottom > BoxRect.Bottom + 1.f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UGuideScrollIntoViewAsyncAction::Success()
+{
+	Clear();
+
+	OnReadyNative.Broadcast(WorldContext, WidgetPtr);
+	OnReady.Broadcast(WorldContext, WidgetPtr);
+
+	SetReadyToDestroy();
+}
+
+void UGuideScrollIntoViewAsyncAction::Fail()
+{
+	Clear();
+
+	OnFailedNative.Broadcast();
+	OnFailed.Broadcast();
+
+	SetReadyToDestroy();
+}
+
+void UGuideScrollIntoViewAsyncAction::Clear()
+{
+	for (UScrollBox* ScrollBox : ScrollBoxes)
+	{
+		if (nullptr != ScrollBox)
+		{
+			ScrollBox->OnUserScrolled.RemoveDynamic(this, &UGuideScrollIntoViewAsyncAction::HandleUserScrolled);
+		}
+	}
+
+	if (SettleHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(SettleHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(SettleHandle);
+#endif
+		SettleHandle.Reset();
+	}
+
+	if (TimeoutHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+#endif
+		TimeoutHandle.Reset();
+	}
+}
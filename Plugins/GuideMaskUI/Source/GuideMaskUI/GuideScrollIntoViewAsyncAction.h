@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Containers/Ticker.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#include "GuideScrollIntoViewAsyncAction.generated.h"
+
+class UScrollBox;
+class UWidget;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnScrollIntoViewReadyEvent, UObject*, InWorldContextObject, UWidget*, InWidget);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnScrollIntoViewFailedEvent);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnScrollIntoViewReadyNativeEvent, UObject*, UWidget*);
+DECLARE_MULTICAST_DELEGATE(FOnScrollIntoViewFailedNativeEvent);
+
+/**
+ * Scrolls every scroll box between the widget and its root so the widget is visible,
+ * then waits until none of them reported a scroll for a while and the new geometry was painted.
+ */
+UCLASS()
+class GUIDEMASKUI_API UGuideScrollIntoViewAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+	
+public:
+	UPROPERTY(BlueprintAssignable) 
+	FOnScrollIntoViewReadyEvent OnReady;
+	FOnScrollIntoViewReadyNativeEvent OnReadyNative;
+
+	UPROPERTY(BlueprintAssignable) 
+	FOnScrollIntoViewFailedEvent OnFailed;
+	FOnScrollIntoViewFailedNativeEvent OnFailedNative;
+
+
+	UFUNCTION(BlueprintCallable, Category = "Guide", meta = (BlueprintInternalUseOnly = "true", WorldContext = "InWorldContextObject", DisplayName = "Wait Guide Scroll Into View"))
+	static UGuideScrollIntoViewAsyncAction* Create(UObject* InWorldContextObject, 
+		UWidget* InWidget, 
+		bool bInAnimateScroll,
+		float InTimeout);
+
+	/** Scroll boxes the widget sits in, innermost first. Crosses user widget boundaries. */
+	static void GetScrollableAncestors(const UWidget* InWidget, OUT TArray<UScrollBox*>& OutScrollBoxes);
+
+	virtual void Activate() override;
+
+	/** Stops waiting without calling OnReady or OnFailed. */
+	void Cancel();
+
+private:
+	UFUNCTION()
+	void HandleUserScrolled(float InCurrentOffset);
+
+	bool HandleSettled(float DeltaTime);
+	bool HandleTimeout(float DeltaTime);
+
+	void RestartSettle();
+	bool IsInView() const;
+
+private:
+	void Success();
+	void Fail();
+	void Clear();
+
+private:
+	UPROPERTY()
+	UObject* WorldContext;
+
+	UPROPERTY()
+	UWidget* WidgetPtr;
+
+	UPROPERTY()
+	TArray<UScrollBox*> ScrollBoxes;
+
+	bool bAnimateScroll = false;
+	float Timeout = 3.f;
+	float SettleSeconds = 0.1f;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle SettleHandle;
+	FTSTicker::FDelegateHandle TimeoutHandle;
+#else
+	FDelegateHandle SettleHandle;
+	FDelegateHandle TimeoutHandle;
+#endif
+};
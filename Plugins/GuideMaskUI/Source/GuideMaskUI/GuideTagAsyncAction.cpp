@@ -0,0 +1,329 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideTagAsyncAction.h"
+#include "GuideMaskRegistrySubsystem.h"
+
+#include "../GuideMaskUI/UI/GuideMaskRegister.h"
+
+#include "Engine/World.h"
+#include "Blueprint/UserWidget.h"
+#include "Framework/Application/SlateApplication.h"
+
+
+namespace GuideTagAsyncAction
+{
+	// A few checks a second, only while a register holds the tag but the target has no geometry.
+	constexpr float HiddenRecheckSeconds = 0.25f;
+}
+
+UGuideTagAsyncAction* UGuideTagAsyncAction::WaitForGuideTag(UObject* InWorldContextObject, FName InTag, float InTimeout)
+{
+	UGuideTagAsyncAction* NewAction = NewObject<UGuideTagAsyncAction>();
+	NewAction->WorldContext = InWorldContextObject;
+	NewAction->Tag = InTag;
+	NewAction->Timeout = InTimeout;
+
+	// The wait may outlive the calling graph, the game instance keeps the action alive until it finishes.
+	NewAction->RegisterWithGameInstance(InWorldContextObject);
+
+	return NewAction;
+}
+
+void UGuideTagAsyncAction::Activate()
+{
+	UGuideMaskRegistrySubsystem* RegistrySubsystem = UGuideMaskRegistrySubsystem::Get(WorldContext);
+	if (nullptr == RegistrySubsystem || Tag.IsNone())
+	{
+		Fail();
+		return;
+	}
+
+	Registry = RegistrySubsystem;
+
+	AddedHandle = RegistrySubsystem->OnRegisterAdded.AddUObject(this, &UGuideTagAsyncAction::HandleRegisterAdded);
+	RemovedHandle = RegistrySubsystem->OnRegisterRemoved.AddUObject(this, &UGuideTagAsyncAction::HandleRegisterRemoved);
+
+	if (Timeout > 0.f)
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		TimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &UGuideTagAsyncAction::HandleTimeout), Timeout);
+#else
+		TimeoutHandle = FTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &UGuideTagAsyncAction::HandleTimeout), Timeout);
+#endif
+	}
+
+	if (UGuideMaskRegister* Register = RegistrySubsystem->FindRegister(WorldContext->GetWorld(), Tag, UGuideMaskRegistrySubsystem::FindLocalPlayer(WorldContext)))
+	{
+		WaitForGeometry(Register);
+	}
+}
+
+void UGuideTagAsyncAction::Cancel()
+{
+	Clear();
+	SetReadyToDestroy();
+}
+
+void UGuideTagAsyncAction::HandleRegisterAdded(UGuideMaskRegister* InRegister)
+{
+	// A screen opening over or around the pending one may have moved or revealed the target, check it once more.
+	if (PendingRegister.IsValid())
+	{
+		ArmPostTick();
+		return;
+	}
+
+	if (nullptr == InRegister || PendingRegister.IsValid() || false == InRegister->IsContains(Tag))
+	{
+		return;
+	}
+
+	if (nullptr != WorldContext && WorldContext->GetWorld() != InRegister->GetWorld())
+	{
+		return;
+	}
+
+	// Split-screen: another player's screen.
+	if (false == UGuideMaskRegistrySubsystem::IsVisibleToPlayer(InRegister, UGuideMaskRegistrySubsystem::FindLocalPlayer(WorldContext)))
+	{
+		return;
+	}
+
+	WaitForGeometry(InRegister);
+}
+
+void UGuideTagAsyncAction::HandleRegisterRemoved(UGuideMaskRegister* InRegister)
+{
+	if (InRegister != PendingRegister.Get())
+	{
+		if (PendingRegister.IsValid())
+		{
+			ArmPostTick();
+		}
+
+		return;
+	}
+
+	PendingRegister.Reset();
+	StopWatchingVisibility();
+
+	// Closed before it was painted, go back to waiting unless another register already holds the tag.
+	UGuideMaskRegistrySubsystem* RegistrySubsystem = Registry.Get();
+	UGuideMaskRegister* Other = nullptr != RegistrySubsystem ? RegistrySubsystem->FindRegister(WorldContext->GetWorld(), Tag, UGuideMaskRegistrySubsystem::FindLocalPlayer(WorldContext)) : nullptr;
+
+	if (nullptr != Other && Other != InRegister)
+	{
+		WaitForGeometry(Other);
+	}
+
+	else
+	{
+		StopPostTick();
+		StopRecheck();
+	}
+}
+
+void UGuideTagAsyncAction::WaitForGeometry(UGuideMaskRegister* InRegister)
+{
+	PendingRegister = InRegister;
+
+	UWidget* TagWidget = InRegister->GetTagWidget(Tag);
+	if (true == HasGeometry(TagWidget))
+	{
+		Success(InRegister, TagWidget);
+		return;
+	}
+
+	if (false == FSlateApplication::IsInitialized())
+	{
+		Success(InRegister, TagWidget);
+		return;
+	}
+
+	// The register was just built, its geometry exists after the next paint.
+	WatchVisibility(TagWidget);
+	ArmPostTick();
+	StartRecheck();
+}
+
+void UGuideTagAsyncAction::HandlePostTick(float DeltaTime)
+{
+	StopPostTick();
+
+	UGuideMaskRegister* Register = PendingRegister.Get();
+	UWidget* TagWidget = nullptr != Register ? Register->GetTagWidget(Tag) : nullptr;
+
+	if (true == HasGeometry(TagWidget))
+	{
+		Success(Register, TagWidget);
+	}
+}
+
+void UGuideTagAsyncAction::HandleVisibilityChanged(ESlateVisibility InVisibility)
+{
+	if (ESlateVisibility::Collapsed != InVisibility && ESlateVisibility::Hidden != InVisibility && PendingRegister.IsValid())
+	{
+		ArmPostTick();
+	}
+}
+
+void UGuideTagAsyncAction::ArmPostTick()
+{
+	if (false == PostTickHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		PostTickHandle = FSlateApplication::Get().OnPostTick().AddUObject(this, &UGuideTagAsyncAction::HandlePostTick);
+	}
+}
+
+void UGuideTagAsyncAction::StopPostTick()
+{
+	if (PostTickHandle.IsValid())
+	{
+		if (FSlateApplication::IsInitialized())
+		{
+			FSlateApplication::Get().OnPostTick().Remove(PostTickHandle);
+		}
+
+		PostTickHandle.Reset();
+	}
+}
+
+void UGuideTagAsyncAction::StartRecheck()
+{
+	if (RecheckHandle.IsValid())
+	{
+		return;
+	}
+
+#if ENGINE_MAJOR_VERSION >= 5
+	RecheckHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideTagAsyncAction::HandleRecheck), GuideTagAsyncAction::HiddenRecheckSeconds);
+#else
+	RecheckHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideTagAsyncAction::HandleRecheck), GuideTagAsyncAction::HiddenRecheckSeconds);
+#endif
+}
+
+void UGuideTagAsyncAction::StopRecheck()
+{
+	if (RecheckHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(RecheckHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(RecheckHandle);
+#endif
+		RecheckHandle.Reset();
+	}
+}
+
+bool UGuideTagAsyncAction::HandleRecheck(float DeltaTime)
+{
+	if (false == PendingRegister.IsValid())
+	{
+		RecheckHandle.Reset();
+		return false;
+	}
+
+	ArmPostTick();
+	return true;
+}
+
+void UGuideTagAsyncAction::WatchVisibility(UWidget* InTagWidget)
+{
+	StopWatchingVisibility();
+
+	UUserWidget* UserWidget = Cast<UUserWidget>(InTagWidget);
+	if (nullptr == UserWidget && nullptr != InTagWidget)
+	{
+		UserWidget = InTagWidget->GetTypedOuter<UUserWidget>();
+	}
+
+	for (; nullptr != UserWidget; UserWidget = UserWidget->GetTypedOuter<UUserWidget>())
+	{
+		UserWidget->OnVisibilityChanged.AddUniqueDynamic(this, &UGuideTagAsyncAction::HandleVisibilityChanged);
+		WatchedWidgets.Emplace(UserWidget);
+	}
+}
+
+void UGuideTagAsyncAction::StopWatchingVisibility()
+{
+	for (const TWeakObjectPtr<UUserWidget>& Watched : WatchedWidgets)
+	{
+		if (UUserWidget* UserWidget = Watched.Get())
+		{
+			UserWidget->OnVisibilityChanged.RemoveDynamic(this, &UGuideTagAsyncAction::HandleVisibilityChanged);
+		}
+	}
+
+	WatchedWidgets.Reset();
+}
+
+bool UGuideTagAsyncAction::HandleTimeout(float DeltaTime)
+{
+	TimeoutHandle.Reset();
+	Fail();
+
+	return false;
+}
+
+bool UGuideTagAsyncAction::HasGeometry(const UWidget* InWidget) const
+{
+	if (nullptr == InWidget || false == InWidget->IsVisible())
+	{
+		return false;
+	}
+
+	const FVector2D Size = InWidget->GetTickSpaceGeometry().GetLocalSize();
+	return Size.X > 0.f && Size.Y > 0.f;
+}
+
+void UGuideTagAsyncAction::Success(UGuideMaskRegister* InRegister, UWidget* InTagWidget)
+{
+	Clear();
+
+	OnReadyNative.Broadcast(InRegister, InTagWidget);
+	OnReady.Broadcast(InRegister, InTagWidget);
+
+	SetReadyToDestroy();
+}
+
+void UGuideTagAsyncAction::Fail()
+{
+	Clear();
+
+	OnTimeoutNative.Broadcast();
+	OnTimeout.Broadcast();
+
+	SetReadyToDestroy();
+}
+
+void UGuideTagAsyncAction::Clear()
+{
+	if (UGuideMaskRegistrySubsystem* RegistrySubsystem = Registry.Get())
+	{
+		RegistrySubsystem->OnRegisterAdded.Remove(AddedHandle);
+		RegistrySubsystem->OnRegisterRemoved.Remove(RemovedHandle);
+	}
+
+	AddedHandle.Reset();
+	RemovedHandle.Reset();
+	PendingRegister.Reset();
+
+	StopWatchingVisibility();
+	StopPostTick();
+	StopRecheck();
+
+	if (TimeoutHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+#endif
+		TimeoutHandle.Reset();
+	}
+}
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Containers/Ticker.h"
+#include "Components/SlateWrapperTypes.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#include "GuideTagAsyncAction.generated.h"
+
+class UGuideMaskRegister;
+class UUserWidget;
+class UGuideMaskRegistrySubsystem;
+class UWidget;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGuideTagReadyEvent, UGuideMaskRegister*, InRegister, UWidget*, InTagWidget);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnGuideTagTimeoutEvent);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnGuideTagReadyNativeEvent, UGuideMaskRegister*, UWidget*);
+DECLARE_MULTICAST_DELEGATE(FOnGuideTagTimeoutNativeEvent);
+
+/**
+ * Completes once a register holding the tag is constructed and the tag widget was laid out.
+ * Waits on the registry's notifications, nothing runs per frame until a matching register shows up.
+ */
+UCLASS()
+class GUIDEMASKUI_API UGuideTagAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+	
+public:
+	UPROPERTY(BlueprintAssignable) 
+	FOnGuideTagReadyEvent OnReady;
+	FOnGuideTagReadyNativeEvent OnReadyNative;
+
+	UPROPERTY(BlueprintAssignable) 
+	FOnGuideTagTimeoutEvent OnTimeout;
+	FOnGuideTagTimeoutNativeEvent OnTimeoutNative;
+
+
+	/** Timeout of 0 or less waits until the tag shows up. */
+	UFUNCTION(BlueprintCallable, Category = "Guide", meta = (BlueprintInternalUseOnly = "true", WorldContext = "InWorldContextObject", DisplayName = "Wait For Guide Tag"))
+	static UGuideTagAsyncAction* WaitForGuideTag(UObject* InWorldContextObject, 
+		FName InTag, 
+		float InTimeout = 0.f);
+
+	virtual void Activate() override;
+
+	/** Stops waiting without calling OnReady or OnTimeout. */
+	void Cancel();
+
+private:
+	void HandleRegisterAdded(UGuideMaskRegister* InRegister);
+	void HandleRegisterRemoved(UGuideMaskRegister* InRegister);
+	void HandlePostTick(float DeltaTime);
+	bool HandleTimeout(float DeltaTime);
+
+	UFUNCTION()
+	void HandleVisibilityChanged(ESlateVisibility InVisibility);
+
+	void WaitForGeometry(UGuideMaskRegister* InRegister);
+	bool HasGeometry(const UWidget* InWidget) const;
+
+	// One post tick check per arm. A target that isn't ready waits for a register or visibility change, nothing runs per frame.
+	void ArmPostTick();
+	void StopPostTick();
+	void WatchVisibility(UWidget* InTagWidget);
+	void StopWatchingVisibility();
+
+	// Panels and widget switchers send no event when they hide the target, a slow recheck covers them.
+	void StartRecheck();
+	void StopRecheck();
+	bool HandleRecheck(float DeltaTime);
+
+private:
+	void Success(UGuideMaskRegister* InRegister, UWidget* InTagWidget);
+	void Fail();
+	void Clear();
+
+private:
+	UPROPERTY()
+	UObject* WorldContext;
+
+	TWeakObjectPtr<UGuideMaskRegister> PendingRegister;
+
+	TWeakObjectPtr<UGuideMaskRegistrySubsystem> Registry;
+
+	// The tag widget and the user widgets around it, any of them turning visible may reveal the target.
+	TArray<TWeakObjectPtr<UUserWidget>> WatchedWidgets;
+
+	FName Tag;
+	float Timeout = 0.f;
+
+	FDelegateHandle AddedHandle;
+	FDelegateHandle RemovedHandle;
+	FDelegateHandle PostTickHandle;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle TimeoutHandle;
+	FTSTicker::FDelegateHandle RecheckHandle;
+#else
+	FDelegateHandle TimeoutHandle;
+	FDelegateHandle RecheckHandle;
+#endif
+};
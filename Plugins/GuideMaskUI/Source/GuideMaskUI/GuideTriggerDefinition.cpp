@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideTriggerDefinition.h"
+
+
+bool UGuideTriggerDefinition::AreConditionsSatisfied(const FGuideTriggerContext& InContext) const
+{
+	for (const UGuideTriggerCondition* Condition : Conditions)
+	{
+		if (nullptr != Condition && false == Condition->IsSatisfied(InContext))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
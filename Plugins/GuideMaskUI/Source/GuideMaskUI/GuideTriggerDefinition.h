@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
+
+#include "../GuideMaskUI/UI/GuideBoxBase.h"
+
+#include "GuideTriggerDefinition.generated.h"
+
+class UGuideMaskRegister;
+
+/**
+ * What fired the trigger. Only the field of the event kind is set.
+ */
+USTRUCT(BlueprintType)
+struct GUIDEMASKUI_API FGuideTriggerContext
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "GuideTrigger")
+	FGameplayTag EventTag;
+
+	UPROPERTY(BlueprintReadOnly, Category = "GuideTrigger")
+	FName ScreenTag;
+
+	UPROPERTY(BlueprintReadOnly, Category = "GuideTrigger")
+	UGuideMaskRegister* Register = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "GuideTrigger")
+	UObject* Payload = nullptr;
+};
+
+
+/**
+ * Extra check of a trigger, run only when one of its events fired.
+ */
+UCLASS(Abstract, Blueprintable, EditInlineNew, DefaultToInstanced)
+class GUIDEMASKUI_API UGuideTriggerCondition : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintNativeEvent, Category = "GuideTrigger")
+	bool IsSatisfied(const FGuideTriggerContext& InContext) const;
+	virtual bool IsSatisfied_Implementation(const FGuideTriggerContext& InContext) const { return true; }
+};
+
+
+/**
+ * A guide and the events that may start it.
+ */
+UCLASS(BlueprintType)
+class GUIDEMASKUI_API UGuideTriggerDefinition : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Progress step of the guide. Completed steps are never triggered again.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trigger")
+	FName StepName;
+
+	// Gameplay events this guide listens to. A parent tag also listens to its children.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trigger")
+	FGameplayTagContainer Events;
+
+	// Fires when a register holding one of these tags is opened.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trigger")
+	TArray<FName> ScreenTags;
+
+	// All have to pass.
+	UPROPERTY(EditDefaultsOnly, Instanced, BlueprintReadOnly, Category = "Trigger")
+	TArray<UGuideTriggerCondition*> Conditions;
+
+	// Marks the step completed as soon as it triggered. Otherwise the game marks it.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trigger")
+	bool bCompleteOnTrigger = true;
+
+	// Tag widget shown through the scheduler when triggered. None only broadcasts.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guide")
+	FName TargetTag;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guide", meta = (EditCondition = "TargetTag != None"))
+	FGuideBoxActionParameters ActionParam;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guide", meta = (EditCondition = "TargetTag != None"))
+	int32 Priority = 0;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guide", meta = (EditCondition = "TargetTag != None"))
+	int32 LayerZOrder = 0;
+
+	// Seconds to wait for the target tag to be laid out. 0 or less waits until it shows up.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guide", meta = (EditCondition = "TargetTag != None"))
+	float ShowTimeout = 5.f;
+
+public:
+	bool AreConditionsSatisfied(const FGuideTriggerContext& InContext) const;
+};
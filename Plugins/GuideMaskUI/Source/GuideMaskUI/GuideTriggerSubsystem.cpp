@@ -0,0 +1,279 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideTriggerSubsystem.h"
+#include "GuideMaskRegistrySubsystem.h"
+#include "GuideProgressSubsystem.h"
+#include "GuideTagAsyncAction.h"
+#include "GuideMaskUIFunctionLibrary.h"
+#include "GuideMaskSettings.h"
+
+#include "../GuideMaskUI/UI/GuideMaskRegister.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+
+UGuideTriggerSubsystem* UGuideTriggerSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = nullptr != WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UGameInstance* GameInstance = nullptr != World ? World->GetGameInstance() : nullptr;
+
+	return nullptr != GameInstance ? GameInstance->GetSubsystem<UGuideTriggerSubsystem>() : nullptr;
+}
+
+void UGuideTriggerSubsystem::RegisterTrigger(UGuideTriggerDefinition* InDefinition)
+{
+	if (nullptr == InDefinition || Definitions.Contains(InDefinition))
+	{
+		return;
+	}
+
+	Definitions.Emplace(InDefinition);
+
+	for (const FGameplayTag& EventTag : InDefinition->Events)
+	{
+		EventIndex.FindOrAdd(EventTag).AddUnique(InDefinition);
+	}
+
+	for (const FName& ScreenTag : InDefinition->ScreenTags)
+	{
+		if (false == ScreenTag.IsNone())
+		{
+			ScreenIndex.FindOrAdd(ScreenTag).AddUnique(InDefinition);
+		}
+	}
+}
+
+void UGuideTriggerSubsystem::UnregisterTrigger(UGuideTriggerDefinition* InDefinition)
+{
+	if (0 == Definitions.Remove(InDefinition))
+	{
+		return;
+	}
+
+	CancelPending(InDefinition);
+
+	for (const FGameplayTag& EventTag : InDefinition->Events)
+	{
+		if (TArray<UGuideTriggerDefinition*>* Found = EventIndex.Find(EventTag))
+		{
+			Found->Remove(InDefinition);
+
+			if (0 == Found->Num())
+			{
+				EventIndex.Remove(EventTag);
+			}
+		}
+	}
+
+	for (const FName& ScreenTag : InDefinition->ScreenTags)
+	{
+		if (TArray<UGuideTriggerDefinition*>* Found = ScreenIndex.Find(ScreenTag))
+		{
+			Found->Remove(InDefinition);
+
+			if (0 == Found->Num())
+			{
+				ScreenIndex.Remove(ScreenTag);
+			}
+		}
+	}
+}
+
+void UGuideTriggerSubsystem::NotifyGuideEvent(FGameplayTag InEventTag, UObject* InPayload)
+{
+	if (false == InEventTag.IsValid() || 0 == EventIndex.Num())
+	{
+		return;
+	}
+
+	FGuideTriggerContext Context;
+	Context.EventTag = InEventTag;
+	Context.Payload = InPayload;
+
+	// The tag itself and every parent, a definition listening to A.B hears A.B.C.
+	TArray<UGuideTriggerDefinition*> Listeners;
+	for (const FGameplayTag& Tag : InEventTag.GetGameplayTagParents())
+	{
+		if (const TArray<UGuideTriggerDefinition*>* Found = EventIndex.Find(Tag))
+		{
+			for (UGuideTriggerDefinition* Definition : *Found)
+			{
+				Listeners.AddUnique(Definition);
+			}
+		}
+	}
+
+	for (UGuideTriggerDefinition* Definition : Listeners)
+	{
+		Evaluate(Definition, Context);
+	}
+}
+
+void UGuideTriggerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UGuideMaskRegistrySubsystem* RegistrySubsystem = Collection.InitializeDependency<UGuideMaskRegistrySubsystem>();
+	Collection.InitializeDependency<UGuideProgressSubsystem>();
+
+	if (nullptr != RegistrySubsystem)
+	{
+		Registry = RegistrySubsystem;
+		RegisterAddedHandle = RegistrySubsystem->OnRegisterAdded.AddUObject(this, &UGuideTriggerSubsystem::HandleRegisterAdded);
+	}
+
+	if (const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>())
+	{
+		for (const TSoftObjectPtr<UGuideTriggerDefinition>& SoftDefinition : Settings->TriggerDefinitions)
+		{
+			RegisterTrigger(SoftDefinition.LoadSynchronous());
+		}
+	}
+}
+
+void UGuideTriggerSubsystem::Deinitialize()
+{
+	if (Registry.IsValid())
+	{
+		Registry->OnRegisterAdded.Remove(RegisterAddedHandle);
+	}
+
+	Registry.Reset();
+	RegisterAddedHandle.Reset();
+
+	for (const auto& Pair : PendingWaits)
+	{
+		if (UGuideTagAsyncAction* WaitAction = Pair.Value.Get())
+		{
+			WaitAction->Cancel();
+		}
+	}
+
+	PendingWaits.Reset();
+	Definitions.Reset();
+	EventIndex.Reset();
+	ScreenIndex.Reset();
+
+	Super::Deinitialize();
+}
+
+void UGuideTriggerSubsystem::HandleRegisterAdded(UGuideMaskRegister* InRegister)
+{
+	if (nullptr == InRegister || 0 == ScreenIndex.Num())
+	{
+		return;
+	}
+
+	for (const auto& Pair : InRegister->GetTagWidgetList())
+	{
+		const TArray<UGuideTriggerDefinition*>* Found = ScreenIndex.Find(Pair.Key);
+		if (nullptr == Found)
+		{
+			continue;
+		}
+
+		FGuideTriggerContext Context;
+		Context.ScreenTag = Pair.Key;
+		Context.Register = InRegister;
+
+		// Copy, a trigger may unregister definitions.
+		const TArray<UGuideTriggerDefinition*> Listeners = *Found;
+		for (UGuideTriggerDefinition* Definition : Listeners)
+		{
+			Evaluate(Definition, Context);
+		}
+	}
+}
+
+void UGuideTriggerSubsystem::Evaluate(UGuideTriggerDefinition* InDefinition, const FGuideTriggerContext& InContext)
+{
+	if (nullptr == InDefinition || true == PendingWaits.Contains(InDefinition))
+	{
+		return;
+	}
+
+	UGuideProgressSubsystem* Progress = UGuideProgressSubsystem::Get(GetGameInstance());
+	if (nullptr != Progress && true == Progress->IsGuideNameCompleted(InDefinition->StepName))
+	{
+		return;
+	}
+
+	if (false == InDefinition->AreConditionsSatisfied(InContext))
+	{
+		return;
+	}
+
+	Trigger(InDefinition, InContext);
+}
+
+void UGuideTriggerSubsystem::Trigger(UGuideTriggerDefinition* InDefinition, const FGuideTriggerContext& InContext)
+{
+	OnGuideTriggered.Broadcast(InDefinition, InContext);
+
+	const bool bCompleteOnShow = InDefinition->bCompleteOnTrigger;
+	const FName StepName = InDefinition->StepName;
+
+	// Nothing to show, the trigger itself completes the step.
+	if (InDefinition->TargetTag.IsNone())
+	{
+		if (true == bCompleteOnShow)
+		{
+			MarkStepCompleted(StepName);
+		}
+
+		return;
+	}
+
+	UObject* WorldContext = nullptr != InContext.Register ? static_cast<UObject*>(InContext.Register) : static_cast<UObject*>(GetGameInstance());
+	if (nullptr == WorldContext->GetWorld())
+	{
+		return;
+	}
+
+	// The screen that fired may still be building, show the guide once the target is laid out.
+	const FGuideBoxActionParameters ActionParam = InDefinition->ActionParam;
+	const int32 LayerZOrder = InDefinition->LayerZOrder;
+	const int32 Priority = InDefinition->Priority;
+
+	UGuideTagAsyncAction* WaitAction = UGuideTagAsyncAction::WaitForGuideTag(WorldContext, InDefinition->TargetTag, InDefinition->ShowTimeout);
+	PendingWaits.Emplace(InDefinition, WaitAction);
+
+	// Completed only once the guide is shown, a wait that times out or a screen that closes first leaves the step open.
+	WaitAction->OnReadyNative.AddWeakLambda(this, [this, InDefinition, ActionParam, LayerZOrder, Priority, bCompleteOnShow, StepName](UGuideMaskRegister* InRegister, UWidget* InTagWidget)
+		{
+			PendingWaits.Remove(InDefinition);
+
+			UGuideMaskUIFunctionLibrary::ShowGuideWidget(InRegister, InTagWidget, ActionParam, LayerZOrder, Priority);
+
+			if (true == bCompleteOnShow)
+			{
+				MarkStepCompleted(StepName);
+			}
+		});
+
+	WaitAction->OnTimeoutNative.AddWeakLambda(this, [this, InDefinition]()
+		{
+			PendingWaits.Remove(InDefinition);
+		});
+
+	WaitAction->Activate();
+}
+
+void UGuideTriggerSubsystem::CancelPending(UGuideTriggerDefinition* InDefinition)
+{
+	TWeakObjectPtr<UGuideTagAsyncAction> WaitAction;
+	if (true == PendingWaits.RemoveAndCopyValue(InDefinition, WaitAction) && WaitAction.IsValid())
+	{
+		WaitAction->Cancel();
+	}
+}
+
+void UGuideTriggerSubsystem::MarkStepCompleted(const FName& InStepName)
+{
+	if (UGuideProgressSubsystem* Progress = UGuideProgressSubsystem::Get(GetGameInstance()))
+	{
+		Progress->MarkGuideCompleted(Progress->GetStepId(InStepName));
+	}
+}
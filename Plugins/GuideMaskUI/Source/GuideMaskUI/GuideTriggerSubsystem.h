@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "GameplayTagContainer.h"
+
+#include "GuideTriggerDefinition.h"
+
+#include "GuideTriggerSubsystem.generated.h"
+
+class UGuideMaskRegister;
+class UGuideMaskRegistrySubsystem;
+class UGuideTagAsyncAction;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGuideTriggered, UGuideTriggerDefinition*, InDefinition, const FGuideTriggerContext&, InContext);
+
+/**
+ * Starts guides from the events they declare instead of polling their conditions.
+ * Definitions are indexed by event tag and by screen tag, an event only evaluates the definitions subscribed to it.
+ */
+UCLASS()
+class GUIDEMASKUI_API UGuideTriggerSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UGuideTriggerSubsystem* Get(const UObject* WorldContextObject);
+
+	UFUNCTION(BlueprintCallable, Category = "Guide Trigger")
+	void RegisterTrigger(UGuideTriggerDefinition* InDefinition);
+
+	UFUNCTION(BlueprintCallable, Category = "Guide Trigger")
+	void UnregisterTrigger(UGuideTriggerDefinition* InDefinition);
+
+	/** Evaluates the definitions listening to the tag or one of its parents. */
+	UFUNCTION(BlueprintCallable, Category = "Guide Trigger")
+	void NotifyGuideEvent(FGameplayTag InEventTag, UObject* InPayload = nullptr);
+
+	/** Forwards every broadcast of a native multicast delegate as the event tag. Remove the returned handle to stop. */
+	template<typename DelegateType>
+	FDelegateHandle ListenToDelegate(DelegateType& InDelegate, FGameplayTag InEventTag)
+	{
+		return InDelegate.AddWeakLambda(this, [this, InEventTag](auto&&...)
+			{
+				NotifyGuideEvent(InEventTag);
+			});
+	}
+
+	UPROPERTY(BlueprintAssignable, Category = "Guide Trigger")
+	FOnGuideTriggered OnGuideTriggered;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	void HandleRegisterAdded(UGuideMaskRegister* InRegister);
+
+	void Evaluate(UGuideTriggerDefinition* InDefinition, const FGuideTriggerContext& InContext);
+	void Trigger(UGuideTriggerDefinition* InDefinition, const FGuideTriggerContext& InContext);
+	void MarkStepCompleted(const FName& InStepName);
+	void CancelPending(UGuideTriggerDefinition* InDefinition);
+
+private:
+	UPROPERTY(Transient)
+	TArray<UGuideTriggerDefinition*> Definitions;
+
+	// Held by Definitions.
+	TMap<FGameplayTag, TArray<UGuideTriggerDefinition*>> EventIndex;
+	TMap<FName, TArray<UGuideTriggerDefinition*>> ScreenIndex;
+
+	// Triggered definitions still waiting for their target, they aren't evaluated again until the wait ends.
+	TMap<UGuideTriggerDefinition*, TWeakObjectPtr<UGuideTagAsyncAction>> PendingWaits;
+
+	TWeakObjectPtr<UGuideMaskRegistrySubsystem> Registry;
+	FDelegateHandle RegisterAddedHandle;
+};
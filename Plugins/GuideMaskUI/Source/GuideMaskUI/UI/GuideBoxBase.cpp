@@ -4,7 +4,10 @@
 #include "GuideBoxBase.h"
 #include "Components/Button.h"
 #include "Components/CheckBox.h"
-//#include "Components/ProgressBar.h"
+#include "Components/Image.h"
+#include "Components/PrimitiveComponent.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Misc/App.h"
 
 #include "Blueprint/WidgetLayoutLibrary.h"
 
@@ -15,15 +18,14 @@ void UGuideBoxBase::SetGuideWidget(UWidget* InWidget)
 {
 	ActionWidget = InWidget;
 
-	/*if (nullptr != HoldProgressBar && nullptr != HoldProgressBar->GetParent())
-	{
-		HoldProgressBar->GetParent()->SetVisibility(ESlateVisibility::Collapsed);
-		HoldProgressBar->SetPercent(0.f);
-	}*/
-
 	//SetGuideAction(InActionParam);
 }
 
+void UGuideBoxBase::SetGuideComponent(UPrimitiveComponent* InComponent)
+{
+	ActionComponent = InComponent;
+}
+
 void UGuideBoxBase::SetGuideAction(const FGuideBoxActionParameters& InActionParam)
 {
 	ActionParam.ActionType = InActionParam.ActionType;
@@ -125,6 +127,21 @@ FReply UGuideBoxBase::NativeOnStartClickAction(const FGeometry& InGeometry, cons
 		return FReply::Handled().CaptureMouse(TakeWidget());
 	}
 
+	else if (ActionComponent.IsValid())
+	{
+		if (InEvent.IsTouchEvent())
+		{
+			ActionComponent->DispatchOnInputTouchBegin((ETouchIndex::Type)InEvent.GetPointerIndex());
+		}
+
+		if (OnMouseDownEvent.IsBound())
+		{
+			OnMouseDownEvent.Broadcast(InGeometry, InEvent);
+		}
+
+		return FReply::Handled().CaptureMouse(TakeWidget());
+	}
+
 	return FReply::Unhandled();
 }
 
@@ -284,14 +301,37 @@ FReply UGuideBoxBase::NativeOnEndClickAction(const FGeometry& InGeometry, const
 		return FReply::Handled().ReleaseMouseCapture();
 	}
 
+	else if (ActionComponent.IsValid())
+	{
+		// World targets get the same events a click / touch through the player controller would give them.
+		if (InEvent.IsTouchEvent())
+		{
+			ActionComponent->DispatchOnInputTouchEnd((ETouchIndex::Type)InEvent.GetPointerIndex());
+		}
+
+		else
+		{
+			ActionComponent->DispatchOnClicked(InEvent.GetEffectingButton());
+		}
+
+		if (OnMouseUpEvent.IsBound())
+		{
+			OnMouseUpEvent.Broadcast(InGeometry, InEvent);
+		}
+
+		NativeOnEndAction(InEvent);
+
+		return FReply::Handled().ReleaseMouseCapture();
+	}
+
 	return FReply::Unhandled();
 }
 
 FReply UGuideBoxBase::NativeOnStartKeyAction(const FGeometry& InGeometry, const FKeyEvent& InEvent)
 {
-	TSharedRef<SWidget> SlateWidget = ActionWidget->TakeWidget();
-	if (ensure(&SlateWidget))
+	if (ActionWidget.IsValid())
 	{
+		TSharedRef<SWidget> SlateWidget = ActionWidget->TakeWidget();
 		SlateWidget->OnKeyDown(InGeometry, InEvent);
 	}
 
@@ -305,12 +345,17 @@ FReply UGuideBoxBase::NativeOnStartKeyAction(const FGeometry& InGeometry, const
 
 FReply UGuideBoxBase::NativeOnEndKeyAction(const FGeometry& InGeometry, const FKeyEvent& InEvent)
 {
-	TSharedRef<SWidget> SlateWidget = ActionWidget->TakeWidget();
-	if (ensure(&SlateWidget))
+	if (ActionWidget.IsValid())
 	{
+		TSharedRef<SWidget> SlateWidget = ActionWidget->TakeWidget();
 		SlateWidget->OnKeyUp(InGeometry, InEvent);
 	}
 
+	else if (ActionComponent.IsValid())
+	{
+		ActionComponent->DispatchOnClicked(InEvent.GetKey());
+	}
+
 	if (OnKeyUpEvent.IsBound())
 	{
 		OnKeyUpEvent.Broadcast(InGeometry, InEvent);
@@ -363,36 +408,19 @@ void UGuideBoxBase::NativeConstruct()
 	bIsFocusable = true;
 #endif
 
+	HideHoldProgress();
+
 }
 
 void UGuideBoxBase::NativeDestruct()
 {
+	StopHold();
+
 	Super::NativeDestruct();
 
 	OnNativeVisibilityChanged.RemoveAll(this);
 }
 
-void UGuideBoxBase::NativeTick(const FGeometry& InGeometry, float InDeltaTime)
-{
-	Super::NativeTick(InGeometry, InDeltaTime);
-
-	if (false == TouchStartPos.IsZero() &&
-		ActionParam.ActionType == EGuideActionType::Hold)
-	{
-		if (FPlatformTime::Seconds() > StartTime + ActionParam.HoldSeconds)
-		{
-			NativeOnEndAction();
-		}
-
-		/*else if (nullptr != HoldProgressBar)
-		{
-			double Value = (FPlatformTime::Seconds() - StartTime) / HoldSeconds;
-
-			HoldProgressBar->SetPercent(Value);
-		}*/
-	}
-}
-
 // PC
 FReply UGuideBoxBase::NativeOnMouseButtonDown(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
 {
@@ -405,11 +433,7 @@ FReply UGuideBoxBase::NativeOnMouseButtonDown(const FGeometry& InGeometry, const
 	{
 		StartTime = FPlatformTime::Seconds();
 		TouchStartPos = InGeometry.AbsoluteToLocal(InMouseEvent.GetScreenSpacePosition());
-
-		/*if (nullptr != HoldProgressBar && HoldProgressBar->GetParent())
-		{
-			HoldProgressBar->GetParent()->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
-		}*/
+		StartHold();
 
 		return FReply::Handled();
 	}
@@ -452,11 +476,6 @@ FReply UGuideBoxBase::NativeOnMouseMove(const FGeometry& InGeometry, const FPoin
 
 FReply UGuideBoxBase::NativeOnMouseButtonUp(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
 {
-	/*if (nullptr != HoldProgressBar && HoldProgressBar->GetParent())
-	{
-		HoldProgressBar->GetParent()->SetVisibility(ESlateVisibility::Collapsed);
-	}*/
-
 	if (false == TouchStartPos.IsZero())
 	{
 
@@ -467,6 +486,7 @@ FReply UGuideBoxBase::NativeOnMouseButtonUp(const FGeometry& InGeometry, const F
 #endif
 
 		StartTime = 0.f;
+		StopHold();
 
 		switch (ActionParam.ActionType)
 		{
@@ -493,11 +513,7 @@ FReply UGuideBoxBase::NativeOnTouchStarted(const FGeometry& InGeometry, const FP
 	{
 		StartTime = FPlatformTime::Seconds();
 		TouchStartPos = InGeometry.AbsoluteToLocal(InGestureEvent.GetScreenSpacePosition());
-
-		/*if (nullptr != HoldProgressBar && HoldProgressBar->GetParent())
-		{
-			HoldProgressBar->GetParent()->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
-		}*/
+		StartHold();
 
 		return FReply::Handled();
 	}
@@ -540,11 +556,6 @@ FReply UGuideBoxBase::NativeOnTouchMoved(const FGeometry& InGeometry, const FPoi
 
 FReply UGuideBoxBase::NativeOnTouchEnded(const FGeometry& InGeometry, const FPointerEvent& InGestureEvent)
 {
-	/*if (nullptr != HoldProgressBar && HoldProgressBar->GetParent())
-	{
-		HoldProgressBar->GetParent()->SetVisibility(ESlateVisibility::Collapsed);
-	}*/
-
 #if ENGINE_MAJOR_VERSION >= 5
 	if (false == TouchStartPos.IsZero())
 #else
@@ -558,6 +569,7 @@ FReply UGuideBoxBase::NativeOnTouchEnded(const FGeometry& InGeometry, const FPoi
 		TouchStartPos = FVector2D::ZeroVector;
 #endif
 		StartTime = 0.f;
+		StopHold();
 
 		switch (ActionParam.ActionType)
 		{
@@ -582,11 +594,7 @@ FReply UGuideBoxBase::NativeOnKeyDown(const FGeometry& InGeometry, const FKeyEve
 		{
 			StartTime = FPlatformTime::Seconds();
 			TouchStartPos = InGeometry.AbsoluteToLocal(FSlateApplication::Get().GetCursorPos());
-
-			/*if (nullptr != HoldProgressBar && HoldProgressBar->GetParent())
-			{
-				HoldProgressBar->GetParent()->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
-			}*/
+			StartHold();
 
 			return NativeOnStartKeyAction(InGeometry, InKeyEvent);
 		}
@@ -602,11 +610,6 @@ FReply UGuideBoxBase::NativeOnKeyDown(const FGeometry& InGeometry, const FKeyEve
 
 FReply UGuideBoxBase::NativeOnKeyUp(const FGeometry& InGeometry, const FKeyEvent& InKeyEvent)
 {
-	/*if (nullptr != HoldProgressBar && HoldProgressBar->GetParent())
-	{
-		HoldProgressBar->GetParent()->SetVisibility(ESlateVisibility::Collapsed);
-	}*/
-
 #if ENGINE_MAJOR_VERSION >= 5
 	if (EGuideActionType::Hold == ActionParam.ActionType && false == TouchStartPos.IsZero())
 #else
@@ -614,6 +617,7 @@ FReply UGuideBoxBase::NativeOnKeyUp(const FGeometry& InGeometry, const FKeyEvent
 #endif
 	{
 		StartTime = 0.f;
+		StopHold();
 
 #if ENGINE_MAJOR_VERSION >= 5
 		TouchStartPos = FVector2D::Zero();
@@ -647,11 +651,6 @@ void UGuideBoxBase::NativeOnMouseEnter(const FGeometry& InGeometry, const FPoint
 
 void UGuideBoxBase::NativeOnMouseLeave(const FPointerEvent& InMouseEvent)
 {
-	/*if (nullptr != HoldProgressBar && HoldProgressBar->GetParent())
-	{
-		HoldProgressBar->GetParent()->SetVisibility(ESlateVisibility::Collapsed);
-	}*/
-
 	if (ActionWidget.IsValid())
 	{
 		TSharedRef<SWidget> SlateWidget = ActionWidget->TakeWidget();
@@ -681,6 +680,8 @@ void UGuideBoxBase::NativeOnMouseLeave(const FPointerEvent& InMouseEvent)
 #else
 		TouchStartPos = FVector2D::ZeroVector;
 #endif
+
+		StopHold();
 	}
 
 	if (EGuideActionType::Hold != ActionParam.ActionType)
@@ -692,6 +693,7 @@ void UGuideBoxBase::NativeOnMouseLeave(const FPointerEvent& InMouseEvent)
 void UGuideBoxBase::Clear()
 {
 	StartTime = 0.f;
+	StopHold();
 
 #if ENGINE_MAJOR_VERSION >= 5
 	TouchStartPos = FVector2D::Zero();
@@ -700,6 +702,7 @@ void UGuideBoxBase::Clear()
 #endif
 
 	ActionWidget.Reset();
+	ActionComponent.Reset();
 
 	ActionParam.WidgetActionEvent.Clear();
 	ActionParam.ActionType = EGuideActionType::None_Action;
@@ -707,6 +710,76 @@ void UGuideBoxBase::Clear()
 	ActionParam.HoldSeconds = 0.f;
 }
 
+void UGuideBoxBase::StartHold()
+{
+	StopHold();
+
+#if ENGINE_MAJOR_VERSION >= 5
+	HoldTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideBoxBase::OnHoldElapsed), FMath::Max(0.f, ActionParam.HoldSeconds));
+#else
+	HoldTickerHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideBoxBase::OnHoldElapsed), FMath::Max(0.f, ActionParam.HoldSeconds));
+#endif
+
+	ShowHoldProgress();
+}
+
+void UGuideBoxBase::StopHold()
+{
+	HideHoldProgress();
+
+	if (false == HoldTickerHandle.IsValid())
+	{
+		return;
+	}
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::GetCoreTicker().RemoveTicker(HoldTickerHandle);
+#else
+	FTicker::GetCoreTicker().RemoveTicker(HoldTickerHandle);
+#endif
+
+	HoldTickerHandle.Reset();
+}
+
+bool UGuideBoxBase::OnHoldElapsed(float InDeltaTime)
+{
+	HoldTickerHandle.Reset();
+
+	if (EGuideActionType::Hold == ActionParam.ActionType && false == TouchStartPos.IsZero())
+	{
+		NativeOnEndAction();
+	}
+
+	// One-shot.
+	return false;
+}
+
+void UGuideBoxBase::ShowHoldProgress()
+{
+	if (nullptr == HoldProgressImage)
+	{
+		return;
+	}
+
+	if (UMaterialInstanceDynamic* ProgressMaterial = HoldProgressImage->GetDynamicMaterial())
+	{
+		ProgressMaterial->SetScalarParameterValue(TEXT("HoldStartTime"), (float)(FApp::GetCurrentTime() - GStartTime));
+		ProgressMaterial->SetScalarParameterValue(TEXT("HoldDuration"), FMath::Max(0.f, ActionParam.HoldSeconds));
+	}
+
+	HoldProgressImage->SetVisibility(ESlateVisibility::HitTestInvisible);
+}
+
+void UGuideBoxBase::HideHoldProgress()
+{
+	if (nullptr != HoldProgressImage && ESlateVisibility::Collapsed != HoldProgressImage->GetVisibility())
+	{
+		HoldProgressImage->SetVisibility(ESlateVisibility::Collapsed);
+	}
+}
+
 void UGuideBoxBase::OnChangedVisibility(ESlateVisibility InVisiblity)
 {
 	switch (InVisiblity)
@@ -4,9 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "Containers/Ticker.h"
+#include "Runtime/Launch/Resources/Version.h"
 #include "GuideBoxBase.generated.h"
 
-//class UProgressBar;
+class UImage;
+class UPrimitiveComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGuideMouseDown,
 	const FGeometry&, InGeometry,
@@ -70,7 +73,7 @@ public:
 };
 
 
-UCLASS()
+UCLASS(meta = (DisableNativeTick))
 class GUIDEMASKUI_API UGuideBoxBase : public UUserWidget
 {
 	GENERATED_BODY()
@@ -79,6 +82,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GuideBoxBase")
 	void SetGuideWidget(UWidget* InWidget);
 
+	/** World target of the guide. Used when there is no action widget, clicks reach it as primitive click / touch events. */
+	UFUNCTION(BlueprintCallable, Category = "GuideBoxBase")
+	void SetGuideComponent(UPrimitiveComponent* InComponent);
+
 	UFUNCTION(BlueprintCallable, Category = "GuideBoxBase")
 	void SetGuideAction(const FGuideBoxActionParameters& InActionParam);
 
@@ -129,7 +136,6 @@ public:
 protected:
 	virtual void NativeConstruct() override;
 	virtual void NativeDestruct() override;
-	virtual void NativeTick(const FGeometry& InGeometry, float InDeltaTime) override;
 
 	virtual FReply NativeOnMouseButtonDown(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
 	virtual FReply NativeOnMouseMove(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
@@ -149,6 +155,15 @@ private:
 	FPointerEvent CreateMouseLikePointerEventFromTouch(const FPointerEvent& InTouchEvent);
 
 	void Clear();
+
+	// Hold completes from a one-shot ticker instead of polling in NativeTick, so the box never ticks.
+	void StartHold();
+	void StopHold();
+	bool OnHoldElapsed(float InDeltaTime);
+
+	// Progress is drawn by the material from the start time and duration, written once per press.
+	void ShowHoldProgress();
+	void HideHoldProgress();
 	
 	void OnResizedViewport(FViewport* InViewport, uint32 InWindowMode /*?*/);
 	void OnChangedVisibility(ESlateVisibility InVisiblity);
@@ -158,10 +173,15 @@ private:
 
 protected:
 	TWeakObjectPtr<UWidget> ActionWidget = nullptr;
+	TWeakObjectPtr<UPrimitiveComponent> ActionComponent = nullptr;
 
 	UPROPERTY(BlueprintReadWrite, BlueprintSetter = SetGuideAction)
 	FGuideBoxActionParameters ActionParam {};
 
+	// Hold progress ring / bar. Its material reads HoldStartTime and HoldDuration against the UI Time node.
+	UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional, AllowPrivateAccess = "true"))
+	UImage* HoldProgressImage = nullptr;
+
 private:
 	double StartTime = 0.f;
 	FVector2D TouchStartPos = FVector2D();
@@ -170,4 +190,10 @@ private:
 
 	EButtonClickMethod::Type CachedClickMethod = EButtonClickMethod::DownAndUp;
 	EButtonTouchMethod::Type CachedTouchMethod = EButtonTouchMethod::DownAndUp;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle HoldTickerHandle;
+#else
+	FDelegateHandle HoldTickerHandle;
+#endif
 };
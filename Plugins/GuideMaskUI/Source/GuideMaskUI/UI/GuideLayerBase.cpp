@@ -10,22 +10,163 @@
 #include "Components/SizeBox.h"
 
 #include "Blueprint/WidgetLayoutLibrary.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Materials/MaterialInstanceDynamic.h"
 
 #include "../GuideMaskSettings.h"
+#include "../GuideLayerHostSubsystem.h"
+#include "../GuideMaskProjection.h"
+
+#include "GameFramework/Actor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/WidgetComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+const FName FGuideMaskParameterBlock::ScalarNames[(uint8)EScalar::Max] =
+{
+	FName(TEXT("Animate")),
+	FName(TEXT("AnimSpeed")),
+	FName(TEXT("Shape")),
+	FName(TEXT("Opacity")),
+	FName(TEXT("TransitionStartTime")),
+	FName(TEXT("TransitionDuration")),
+};
+
+const FName FGuideMaskParameterBlock::VectorNames[(uint8)EVector::Max] =
+{
+	FName(TEXT("Center")),
+	FName(TEXT("Size")),
+	FName(TEXT("PrevCenter")),
+	FName(TEXT("PrevSize")),
+};
+
+void FGuideMaskParameterBlock::SetScalar(EScalar InParam, float InValue)
+{
+	const uint8 Index = (uint8)InParam;
+	const uint32 Bit = 1u << Index;
+
+	Scalars[Index] = InValue;
+
+	if (0 != (WrittenScalarMask & Bit) && WrittenScalars[Index] == InValue)
+	{
+		DirtyScalars &= ~Bit;
+	}
+
+	else
+	{
+		DirtyScalars |= Bit;
+	}
+}
+
+void FGuideMaskParameterBlock::SetVector(EVector InParam, const FLinearColor& InValue)
+{
+	const uint8 Index = (uint8)InParam;
+	const uint32 Bit = 1u << Index;
+
+	Vectors[Index] = InValue;
+
+	if (0 != (WrittenVectorMask & Bit) && WrittenVectors[Index] == InValue)
+	{
+		DirtyVectors &= ~Bit;
+	}
+
+	else
+	{
+		DirtyVectors |= Bit;
+	}
+}
+
+bool FGuideMaskParameterBlock::Flush(UMaterialInstanceDynamic* InMaterial)
+{
+	if (nullptr == InMaterial)
+	{
+		return false;
+	}
+
+	if (BoundMaterial.Get() != InMaterial)
+	{
+		Bind(InMaterial);
+	}
+
+	if (false == IsDirty())
+	{
+		return false;
+	}
+
+	for (uint8 i = 0; i < (uint8)EScalar::Max; ++i)
+	{
+		if (0 == (DirtyScalars & (1u << i)))
+		{
+			continue;
+		}
+
+		// Index is INDEX_NONE if the material has no such parameter, or stale if someone cleared the parameters.
+		if (INDEX_NONE == ScalarIndices[i] || false == InMaterial->SetScalarParameterByIndex(ScalarIndices[i], Scalars[i]))
+		{
+			InMaterial->InitializeScalarParameterAndGetIndex(ScalarNames[i], Scalars[i], ScalarIndices[i]);
+		}
+
+		WrittenScalars[i] = Scalars[i];
+	}
+
+	for (uint8 i = 0; i < (uint8)EVector::Max; ++i)
+	{
+		if (0 == (DirtyVectors & (1u << i)))
+		{
+			continue;
+		}
+
+		if (INDEX_NONE == VectorIndices[i] || false == InMaterial->SetVectorParameterByIndex(VectorIndices[i], Vectors[i]))
+		{
+			InMaterial->InitializeVectorParameterAndGetIndex(VectorNames[i], Vectors[i], VectorIndices[i]);
+		}
+
+		WrittenVectors[i] = Vectors[i];
+	}
+
+	WrittenScalarMask |= DirtyScalars;
+	WrittenVectorMask |= DirtyVectors;
+
+	DirtyScalars = 0;
+	DirtyVectors = 0;
+
+	return true;
+}
+
+void FGuideMaskParameterBlock::Bind(UMaterialInstanceDynamic* InMaterial)
+{
+	BoundMaterial = InMaterial;
+
+	// Nothing was written to this instance yet, so everything recorded so far is dirty.
+	DirtyScalars |= WrittenScalarMask;
+	DirtyVectors |= WrittenVectorMask;
+
+	WrittenScalarMask = 0;
+	WrittenVectorMask = 0;
+
+	for (uint8 i = 0; i < (uint8)EScalar::Max; ++i)
+	{
+		ScalarIndices[i] = INDEX_NONE;
+	}
+
+	for (uint8 i = 0; i < (uint8)EVector::Max; ++i)
+	{
+		VectorIndices[i] = INDEX_NONE;
+	}
+}
+
 
 #if WITH_EDITOR
 void UGuideLayerBase::SetPreviewGuide(const FGeometry& InViewportGeometry, UWidget* InWidget)
 {
 	SetGuideInternal(InViewportGeometry, InWidget);
 
-	// Get target location
-	FVector2D TargetLocalPosition = InViewportGeometry.AbsoluteToLocal(InWidget->GetTickSpaceGeometry().AbsolutePosition);
-	FVector2D TargetLocation = InViewportGeometry.GetLocalPositionAtCoordinates(FVector2D(0, 0)) + TargetLocalPosition;
-
-	// Get target size
-	FVector2D TargetLocalBottomRight = InViewportGeometry.AbsoluteToLocal(InWidget->GetTickSpaceGeometry().LocalToAbsolute(InWidget->GetTickSpaceGeometry().GetLocalSize()));
-	FVector2D TargetLocalTopLeft = InViewportGeometry.AbsoluteToLocal(InWidget->GetTickSpaceGeometry().GetAbsolutePosition());
-	FVector2D TargetLocalSize = TargetLocalBottomRight - TargetLocalTopLeft;
+	FVector2D TargetLocation;
+	FVector2D TargetLocalSize;
+	GetWidgetViewportRect(InViewportGeometry, InWidget, TargetLocation, TargetLocalSize);
 
 	const FVector2D GuideWidgetPosition = TargetLocation - FVector2D(GuideBoxOffset.Left, GuideBoxOffset.Top);
 	const FVector2D GuideWidgetSize = TargetLocalSize + FVector2D(GuideBoxOffset.Left + GuideBoxOffset.Right, GuideBoxOffset.Top + GuideBoxOffset.Bottom);
@@ -78,12 +219,89 @@ void UGuideLayerBase::SetGuide(UWidget* InWidget, const FGuideBoxActionParameter
 		return;
 	}
 
+	StopWorldTracking();
+
+	FLinearColor FromCenter;
+	FLinearColor FromSize;
+	GetDisplayedRect(FromCenter, FromSize);
+
+	const bool bTransition = TransitionDuration > 0.f && true == bHasGuideRect;
+
 	GuideWidget = InWidget;
-	SetGuideInternal(UWidgetLayoutLibrary::GetViewportWidgetGeometry(GetWorld()), InWidget);
 
-	if (nullptr != BoxBaseWidget && InParameter.ActionType != EGuideActionType::None_Action)
+	// Widgets drawn by a world space widget component are projected like any other world target.
+	if (UWidgetComponent* WidgetComponent = FGuideWidgetComponentSpace::FindHostComponent(InWidget))
+	{
+		GuideWidgetComponent = WidgetComponent;
+		StartWorldTracking();
+	}
+
+	else
+	{
+		SetGuideInternal(GetGuideViewportGeometry(), InWidget);
+	}
+
+	StartGuide(InWidget, InParameter, bTransition, FromCenter, FromSize);
+}
+
+void UGuideLayerBase::SetGuideActor(AActor* InActor, const FGuideBoxActionParameters& InParameter)
+{
+	if (nullptr == InActor)
+	{
+		return;
+	}
+
+	SetGuideWorldTarget(InActor, nullptr, InParameter);
+}
+
+void UGuideLayerBase::SetGuideComponent(USceneComponent* InComponent, const FGuideBoxActionParameters& InParameter)
+{
+	if (nullptr == InComponent)
+	{
+		return;
+	}
+
+	SetGuideWorldTarget(InComponent->GetOwner(), InComponent, InParameter);
+}
+
+void UGuideLayerBase::SetGuideWorldTarget(AActor* InActor, USceneComponent* InComponent, const FGuideBoxActionParameters& InParameter)
+{
+	FLinearColor FromCenter;
+	FLinearColor FromSize;
+	GetDisplayedRect(FromCenter, FromSize);
+
+	const bool bTransition = TransitionDuration > 0.f && true == bHasGuideRect;
+
+	GuideWidget.Reset();
+	GuideWidgetComponent.Reset();
+	GuideActor = InActor;
+	GuideComponent = InComponent;
+
+	StartWorldTracking();
+
+	StartGuide(nullptr, InParameter, bTransition, FromCenter, FromSize);
+}
+
+void UGuideLayerBase::StartGuide(UWidget* InWidget, const FGuideBoxActionParameters& InParameter, bool bInTransition, const FLinearColor& InFromCenter, const FLinearColor& InFromSize)
+{
+	bHasGuideRect = true;
+	bGuideActive = true;
+
+	if (true == bInTransition)
+	{
+		StartTransition(InFromCenter, InFromSize);
+	}
+
+	else
+	{
+		StopTransition();
+	}
+
+	if (InParameter.ActionType != EGuideActionType::None_Action && true == EnsureGuideBox())
 	{
+		// World targets have no widget, the box forwards to their primitive instead.
 		BoxBaseWidget->SetGuideWidget(InWidget);
+		BoxBaseWidget->SetGuideComponent(nullptr == InWidget ? GetWorldTargetPrimitive() : nullptr);
 		BoxBaseWidget->SetGuideAction(InParameter);
 
 		if (nullptr != GuideBoxPanel)
@@ -100,7 +318,82 @@ void UGuideLayerBase::SetGuide(UWidget* InWidget, const FGuideBoxActionParameter
 		}
 	}
 
-	OnStartGuide(InWidget, InParameter);
+	FVector2D StartSafePosition;
+	FVector2D StartSafeSize;
+	GetSafeRect(StartSafePosition, StartSafeSize);
+
+	OnStartGuide(InWidget, InParameter, StartSafePosition, StartSafeSize);
+}
+
+bool UGuideLayerBase::EnsureGuideBox()
+{
+	if (nullptr != BoxBaseWidget)
+	{
+		return true;
+	}
+
+	// A panel filled in the designer keeps its own content.
+	if (nullptr == GuideBoxPanel || GuideBoxPanel->GetChildrenCount() > 0)
+	{
+		return false;
+	}
+
+	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
+	if (false == ensureAlways(Settings))
+	{
+		return false;
+	}
+
+	if (!ensureAlwaysMsgf(Settings->DefaultBox.ToSoftObjectPath().IsValid(),
+		TEXT("Invalid Box base class in the project settings.")))
+	{
+		return false;
+	}
+
+	TSubclassOf<UGuideBoxBase> BoxBaseClass = Settings->DefaultBox.Get();
+	if (nullptr == BoxBaseClass)
+	{
+		BoxBaseClass = Settings->DefaultBox.LoadSynchronous();
+	}
+
+	BoxBaseWidget = CreateWidget<UGuideBoxBase>(this, BoxBaseClass);
+	if (false == ensure(BoxBaseWidget))
+	{
+		return false;
+	}
+
+	if (USizeBoxSlot* PanelSlot = Cast<USizeBoxSlot>(GuideBoxPanel->AddChild(BoxBaseWidget)))
+	{
+		PanelSlot->SetHorizontalAlignment(EHorizontalAlignment::HAlign_Fill);
+		PanelSlot->SetVerticalAlignment(EVerticalAlignment::VAlign_Fill);
+	}
+
+	BoxBaseWidget->SetVisibility(ESlateVisibility::Visible);
+	BoxBaseWidget->OnCompleteActionEvent.AddDynamic(this, &UGuideLayerBase::HandleActionCompleted);
+
+	return true;
+}
+
+void UGuideLayerBase::ResetGuide()
+{
+	NotifyGuideFinished();
+	StopTransition();
+	StopWorldTracking();
+
+	GuideWidget.Reset();
+	bHasGuideRect = false;
+
+	// The box stays in the panel for the next guide of this layer.
+	if (nullptr != BoxBaseWidget)
+	{
+		BoxBaseWidget->SetGuideWidget(nullptr);
+		BoxBaseWidget->SetGuideComponent(nullptr);
+	}
+
+	if (nullptr != GuideBoxPanel)
+	{
+		GuideBoxPanel->SetVisibility(ESlateVisibility::Collapsed);
+	}
 }
 
 void UGuideLayerBase::SetGuideInternal(const FGeometry& InViewportGeometry, UWidget* InWidget)
@@ -110,21 +403,34 @@ void UGuideLayerBase::SetGuideInternal(const FGeometry& InViewportGeometry, UWid
 	ForceLayoutPrepass();
 	InWidget->ForceLayoutPrepass();
 
+	FVector2D TargetLocation;
+	FVector2D TargetLocalSize;
+	if (true == GetWidgetViewportRect(InViewportGeometry, InWidget, TargetLocation, TargetLocalSize))
+	{
+		ApplyGuideRect(InViewportGeometry, TargetLocation, TargetLocalSize);
+	}
+}
 
-	// Get target location
-	FVector2D TargetLocalPosition = InViewportGeometry.AbsoluteToLocal(InWidget->GetTickSpaceGeometry().AbsolutePosition);
-	FVector2D TargetLocation = InViewportGeometry.GetLocalPositionAtCoordinates(FVector2D(0, 0)) + TargetLocalPosition;
-
+void UGuideLayerBase::ApplyGuideRect(const FGeometry& InViewportGeometry, const FVector2D& InTargetPosition, const FVector2D& InTargetSize)
+{
 	// Get screen size
 	FVector2D ScreenSize = InViewportGeometry.GetLocalPositionAtCoordinates(FVector2D(0.5, 0.5)) * 2.f;
+	if (ScreenSize.X <= 0.f || ScreenSize.Y <= 0.f)
+	{
+		return;
+	}
 
-	// Get target size
-	FVector2D TargetLocalBottomRight = InViewportGeometry.AbsoluteToLocal(InWidget->GetTickSpaceGeometry().LocalToAbsolute(InWidget->GetTickSpaceGeometry().GetLocalSize()));
-	FVector2D TargetLocalTopLeft = InViewportGeometry.AbsoluteToLocal(InWidget->GetTickSpaceGeometry().GetAbsolutePosition());
-	FVector2D TargetLocalSize = TargetLocalBottomRight - TargetLocalTopLeft;
+	FVector2D GuideWidgetPosition;
+	FVector2D GuideWidgetSize;
+	GetGuideBoxRect(GuideBoxOffset, InTargetPosition, InTargetSize, GuideWidgetPosition, GuideWidgetSize);
 
-	const FVector2D GuideWidgetPosition = TargetLocation - FVector2D(GuideBoxOffset.Left, GuideBoxOffset.Top);
-	const FVector2D GuideWidgetSize = TargetLocalSize + FVector2D(GuideBoxOffset.Left + GuideBoxOffset.Right, GuideBoxOffset.Top + GuideBoxOffset.Bottom);
+	// The box offset doesn't grow into the notch, the target itself is always kept.
+	FVector2D ClampPosition;
+	FVector2D ClampSize;
+	if (true == GetSafeRect(ClampPosition, ClampSize))
+	{
+		ClampGuideBoxRect(ClampPosition, ClampSize, InTargetPosition, InTargetSize, GuideWidgetPosition, GuideWidgetSize);
+	}
 
 	FVector2D WidgetLeftTop = FVector2D(GuideWidgetPosition.X + GuideWidgetSize.X * 0.5f, GuideWidgetPosition.Y + GuideWidgetSize.Y * 0.5f);
 	FVector2D WidgetCenter_Pixel = WidgetLeftTop;
@@ -135,11 +441,9 @@ void UGuideLayerBase::SetGuideInternal(const FGeometry& InViewportGeometry, UWid
 	FVector2D SizeUV = WidgetSize_Pixel / ScreenSize;
 
 	// 머티리얼 파라미터로 넘기기
-	if (ensure(MaterialInstance))
-	{
-		MaterialInstance->SetVectorParameterValue("Center", FLinearColor(CenterUV.X, CenterUV.Y, 0, 0));
-		MaterialInstance->SetVectorParameterValue("Size", FLinearColor(SizeUV.X, SizeUV.Y, 0, 0));
-	}
+	MaskParameters.SetVector(FGuideMaskParameterBlock::EVector::Center, FLinearColor(CenterUV.X, CenterUV.Y, 0, 0));
+	MaskParameters.SetVector(FGuideMaskParameterBlock::EVector::Size, FLinearColor(SizeUV.X, SizeUV.Y, 0, 0));
+	RequestMaskFlush();
 
 	if (nullptr != GuideBoxPanel)
 	{
@@ -150,40 +454,147 @@ void UGuideLayerBase::SetGuideInternal(const FGeometry& InViewportGeometry, UWid
 			PanelSlot->SetPosition(GuideWidgetPosition);
 		}
 	}
+}
+
+bool UGuideLayerBase::GetSafeRect(FVector2D& OutPosition, FVector2D& OutSize)
+{
+	if (true == bSafeRectDirty)
+	{
+		RefreshSafeRect();
+	}
+
+	OutPosition = SafePosition;
+	OutSize = SafeSize;
 
+	return false == bSafeRectDirty;
+}
+
+bool UGuideLayerBase::RefreshSafeRect()
+{
+	const FGeometry LayerGeometry = GetGuideViewportGeometry();
+	const FVector2D LayerSize = LayerGeometry.GetLocalSize();
+	if (LayerSize.X <= 0.f || LayerSize.Y <= 0.f || false == FSlateApplication::IsInitialized())
+	{
+		// Not laid out yet, try again on the next use.
+		SafePosition = FVector2D::ZeroVector;
+		SafeSize = FVector2D::ZeroVector;
+		return false;
+	}
+
+	// The safe zone is relative to the whole viewport, a split-screen region only loses the edges it shares with it.
+	const FGeometry ViewportGeometry = UWidgetLayoutLibrary::GetViewportWidgetGeometry(GetWorld());
+	const FVector2D ViewportSize = ViewportGeometry.GetLocalSize();
+	const float ViewportScale = FMath::Max(UWidgetLayoutLibrary::GetViewportScale(this), KINDA_SMALL_NUMBER);
+
+	// Pixels of the viewport, debug safe zones (r.DebugSafeZone.*) included.
+	FMargin SafeMargin;
+	FSlateApplication::Get().GetSafeZoneSize(SafeMargin, ViewportSize * ViewportScale);
+
+	FVector2D ViewportSafePosition;
+	FVector2D ViewportSafeSize;
+	GetViewportSafeRect(SafeMargin, ViewportSize, ViewportScale, ViewportSafePosition, ViewportSafeSize);
+
+	const FVector2D SafeMin = ViewportGeometry.LocalToAbsolute(ViewportSafePosition);
+	const FVector2D SafeMax = ViewportGeometry.LocalToAbsolute(ViewportSafePosition + ViewportSafeSize);
+
+	const FVector2D LocalMin = LayerGeometry.AbsoluteToLocal(SafeMin).ComponentMax(FVector2D::ZeroVector);
+	const FVector2D LocalMax = LayerGeometry.AbsoluteToLocal(SafeMax).ComponentMin(LayerSize);
+
+	SafePosition = LocalMin;
+	SafeSize = (LocalMax - LocalMin).ComponentMax(FVector2D::ZeroVector);
+	bSafeRectDirty = false;
+
+	return true;
+}
+
+FGeometry UGuideLayerBase::GetGuideViewportGeometry() const
+{
+	if (APlayerController* PlayerController = GetOwningPlayer())
+	{
+		return UWidgetLayoutLibrary::GetPlayerScreenWidgetGeometry(PlayerController);
+	}
+
+	return UWidgetLayoutLibrary::GetViewportWidgetGeometry(GetWorld());
+}
+
+bool UGuideLayerBase::GetWidgetViewportRect(const FGeometry& InViewportGeometry, const UWidget* InWidget, FVector2D& OutPosition, FVector2D& OutSize)
+{
+	if (nullptr == InWidget)
+	{
+		return false;
+	}
+
+	GetGeometryViewportRect(InViewportGeometry, InWidget->GetTickSpaceGeometry(), OutPosition, OutSize);
+	return true;
+}
+
+void UGuideLayerBase::GetGeometryViewportRect(const FGeometry& InViewportGeometry, const FGeometry& InWidgetGeometry, FVector2D& OutPosition, FVector2D& OutSize)
+{
+	// Get target location
+	FVector2D TargetLocalPosition = InViewportGeometry.AbsoluteToLocal(InWidgetGeometry.AbsolutePosition);
+	OutPosition = InViewportGeometry.GetLocalPositionAtCoordinates(FVector2D(0, 0)) + TargetLocalPosition;
+
+	// Get target size
+	FVector2D TargetLocalBottomRight = InViewportGeometry.AbsoluteToLocal(InWidgetGeometry.LocalToAbsolute(InWidgetGeometry.GetLocalSize()));
+	FVector2D TargetLocalTopLeft = InViewportGeometry.AbsoluteToLocal(InWidgetGeometry.GetAbsolutePosition());
+	OutSize = TargetLocalBottomRight - TargetLocalTopLeft;
+}
+
+void UGuideLayerBase::GetGuideBoxRect(const FMargin& InBoxOffset, const FVector2D& InTargetPosition, const FVector2D& InTargetSize, FVector2D& OutPosition, FVector2D& OutSize)
+{
+	OutPosition = InTargetPosition - FVector2D(InBoxOffset.Left, InBoxOffset.Top);
+	OutSize = InTargetSize + FVector2D(InBoxOffset.Left + InBoxOffset.Right, InBoxOffset.Top + InBoxOffset.Bottom);
+}
+
+void UGuideLayerBase::ClampGuideBoxRect(const FVector2D& InSafePosition, const FVector2D& InSafeSize, const FVector2D& InTargetPosition, const FVector2D& InTargetSize,
+	FVector2D& InOutPosition, FVector2D& InOutSize)
+{
+	const FVector2D BoxMin = InOutPosition.ComponentMax(InSafePosition.ComponentMin(InTargetPosition));
+	const FVector2D BoxMax = (InOutPosition + InOutSize).ComponentMin((InSafePosition + InSafeSize).ComponentMax(InTargetPosition + InTargetSize));
+
+	InOutPosition = BoxMin;
+	InOutSize = BoxMax - BoxMin;
+}
+
+void UGuideLayerBase::GetViewportSafeRect(const FMargin& InSafeMargin, const FVector2D& InViewportSize, float InViewportScale, FVector2D& OutPosition, FVector2D& OutSize)
+{
+	const float Scale = FMath::Max(InViewportScale, KINDA_SMALL_NUMBER);
+
+	OutPosition = FVector2D(InSafeMargin.Left, InSafeMargin.Top) / Scale;
+	OutSize = (InViewportSize - FVector2D(InSafeMargin.Left + InSafeMargin.Right, InSafeMargin.Top + InSafeMargin.Bottom) / Scale).ComponentMax(FVector2D::ZeroVector);
 }
 
 FVector2D UGuideLayerBase::GetWidgetPosition() const
 {
-	if (true == GuideWidget.IsValid())
+	if (true == bHasProjectedRect)
 	{
-		const FGeometry ViewportGeometry = UWidgetLayoutLibrary::GetViewportWidgetGeometry(GetWorld());
+		return ProjectedPosition;
+	}
 
-		// Get target location
-		FVector2D TargetLocalPosition = ViewportGeometry.AbsoluteToLocal(GuideWidget->GetTickSpaceGeometry().AbsolutePosition);
-		FVector2D TargetLocation = ViewportGeometry.GetLocalPositionAtCoordinates(FVector2D(0, 0)) + TargetLocalPosition;
+	else if (true == GuideWidget.IsValid())
+	{
+		FVector2D TargetLocation;
+		FVector2D TargetLocalSize;
+		GetWidgetViewportRect(GetGuideViewportGeometry(), GuideWidget.Get(), TargetLocation, TargetLocalSize);
 
 		return TargetLocation;
 	}
 
-
 	return FVector2D();
 }
 
 FVector2D UGuideLayerBase::GetWidgetSize() const
 {
-	if (true == GuideWidget.IsValid())
+	if (true == bHasProjectedRect)
 	{
-		const FGeometry ViewportGeometry = UWidgetLayoutLibrary::GetViewportWidgetGeometry(GetWorld());
-
-		// Get target location
-		FVector2D TargetLocalPosition = ViewportGeometry.AbsoluteToLocal(GuideWidget->GetTickSpaceGeometry().AbsolutePosition);
-		FVector2D TargetLocation = ViewportGeometry.GetLocalPositionAtCoordinates(FVector2D(0, 0)) + TargetLocalPosition;
+		return ProjectedSize;
+	}
 
-		// Get target size
-		FVector2D TargetLocalBottomRight = ViewportGeometry.AbsoluteToLocal(GuideWidget->GetTickSpaceGeometry().LocalToAbsolute(GuideWidget->GetTickSpaceGeometry().GetLocalSize()));
-		FVector2D TargetLocalTopLeft = ViewportGeometry.AbsoluteToLocal(GuideWidget->GetTickSpaceGeometry().GetAbsolutePosition());
-		FVector2D TargetLocalSize = TargetLocalBottomRight - TargetLocalTopLeft;
+	else if (true == GuideWidget.IsValid())
+	{
+		FVector2D TargetLocation;
+		FVector2D TargetLocalSize;
+		GetWidgetViewportRect(GetGuideViewportGeometry(), GuideWidget.Get(), TargetLocation, TargetLocalSize);
 
 		return TargetLocalSize;
 	}
@@ -195,11 +606,9 @@ void UGuideLayerBase::SetEnableAnim(bool bIsEnable)
 {
 	bAnimated = bIsEnable;
 
-	if (ensure(MaterialInstance))
-	{
-		MaterialInstance->SetScalarParameterValue(TEXT("Animate"), true == bAnimated ? 1.f : 0.f);
-		MaterialInstance->SetScalarParameterValue(TEXT("AnimSpeed"), true == bAnimated ? 1.f : 0.f);
-	}
+	MaskParameters.SetScalar(FGuideMaskParameterBlock::EScalar::Animate, true == bAnimated ? 1.f : 0.f);
+	MaskParameters.SetScalar(FGuideMaskParameterBlock::EScalar::AnimSpeed, true == bAnimated ? 1.f : 0.f);
+	RequestMaskFlush();
 }
 
 bool UGuideLayerBase::IsEnabledAnim() const
@@ -211,10 +620,8 @@ void UGuideLayerBase::SetCircularShape(bool bIsEnable)
 {
 	bShapeCircle = bIsEnable;
 
-	if (ensure(MaterialInstance))
-	{
-		MaterialInstance->SetScalarParameterValue(TEXT("Shape"), true == bShapeCircle ? 1.f : 0.f);
-	}
+	MaskParameters.SetScalar(FGuideMaskParameterBlock::EScalar::Shape, true == bShapeCircle ? 1.f : 0.f);
+	RequestMaskFlush();
 }
 
 bool UGuideLayerBase::IsCircularShape() const
@@ -226,10 +633,8 @@ void UGuideLayerBase::SetOpacity(float InOpacity)
 {
 	Opacity = InOpacity;
 
-	if (ensure(MaterialInstance))
-	{
-		MaterialInstance->SetScalarParameterValue(TEXT("Opacity"), Opacity);
-	}
+	MaskParameters.SetScalar(FGuideMaskParameterBlock::EScalar::Opacity, Opacity);
+	RequestMaskFlush();
 }
 
 float UGuideLayerBase::GetOpacity() const
@@ -243,7 +648,7 @@ void UGuideLayerBase::SetBoxOffset(const FMargin& InMargin)
 
 	if (true == GuideWidget.IsValid())
 	{
-		SetGuideInternal(UWidgetLayoutLibrary::GetViewportWidgetGeometry(GetWorld()), GuideWidget.Get());
+		SetGuideInternal(GetGuideViewportGeometry(), GuideWidget.Get());
 	}
 }
 
@@ -252,12 +657,30 @@ const FMargin& UGuideLayerBase::GetBoxOffset() const
 	return GuideBoxOffset;
 }
 
+void UGuideLayerBase::SetTransitionDuration(float InDuration)
+{
+	TransitionDuration = FMath::Max(0.f, InDuration);
+}
+
+float UGuideLayerBase::GetTransitionDuration() const
+{
+	return TransitionDuration;
+}
+
+bool UGuideLayerBase::IsTransitioning() const
+{
+	return TransitionTickerHandle.IsValid();
+}
+
 void UGuideLayerBase::NativeConstruct()
 {
 	Super::NativeConstruct();
 
 	MaterialInstance = BlackScreen->GetDynamicMaterial();
 
+	// Values recorded before the material existed.
+	RequestMaskFlush();
+
 	if (nullptr != LayerPanel)
 	{
 		LayerPanel->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
@@ -268,48 +691,33 @@ void UGuideLayerBase::NativeConstruct()
 		BlackScreen->SetVisibility(ESlateVisibility::Visible);
 	}
 
+	// The box is made by the first guide that needs input, dim-only guides never pay for it.
 	if (nullptr != GuideBoxPanel)
 	{
 		GuideBoxPanel->SetVisibility(ESlateVisibility::Collapsed);
-
-		if (GuideBoxPanel->GetChildrenCount() <= 0)
-		{
-			const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
-			if (ensureAlways(Settings))
-			{
-				if (!ensureAlwaysMsgf(Settings->DefaultBox.ToSoftObjectPath().IsValid(),
-					TEXT("Invalid Box base class in the project settings.")))
-				{
-					return;
-				}
-
-				TSubclassOf<UGuideBoxBase> BoxBaseClass = Settings->DefaultBox.LoadSynchronous();
-
-				BoxBaseWidget = CreateWidget<UGuideBoxBase>(this, BoxBaseClass);
-
-				if (ensure(BoxBaseWidget))
-				{
-					if (USizeBoxSlot* PanelSlot = Cast<USizeBoxSlot>(GuideBoxPanel->AddChild(BoxBaseWidget)))
-					{
-						PanelSlot->SetHorizontalAlignment(EHorizontalAlignment::HAlign_Fill);
-						PanelSlot->SetVerticalAlignment(EVerticalAlignment::VAlign_Fill);
-					}
-
-
-					BoxBaseWidget->SetVisibility(ESlateVisibility::Visible);
-					BoxBaseWidget->OnCompleteActionEvent.AddDynamic(this, &UGuideLayerBase::OnEndGuide);
-				}
-			}
-		}
 	}
 
-
 	FViewport::ViewportResizedEvent.AddUObject(this, &UGuideLayerBase::OnResizedViewport);
+	FCoreDelegates::OnSafeFrameChangedEvent.AddUObject(this, &UGuideLayerBase::OnSafeFrameChanged);
+
+	// A pooled layer may come back on another player's region.
+	bSafeRectDirty = true;
 }
 
 void UGuideLayerBase::NativeDestruct()
 {
 	FViewport::ViewportResizedEvent.RemoveAll(this);
+	FCoreDelegates::OnSafeFrameChangedEvent.RemoveAll(this);
+	StopTransition();
+	StopWorldTracking();
+	NotifyGuideFinished();
+
+	if (MaskFlushHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnPreTick().Remove(MaskFlushHandle);
+	}
+
+	MaskFlushHandle.Reset();
 	MaterialInstance = nullptr;
 
 	Super::NativeDestruct();
@@ -339,6 +747,7 @@ void UGuideLayerBase::SynchronizeProperties()
 	if (BlackScreen && nullptr == MaterialInstance)
 	{
 		MaterialInstance = BlackScreen->GetDynamicMaterial();
+		RequestMaskFlush();
 	}
 
 
@@ -349,8 +758,9 @@ void UGuideLayerBase::SynchronizeProperties()
 		SetCircularShape(bShapeCircle);
 		SetOpacity(Opacity);
 
-		const FVector2D GuideWidgetPosition = ScreenPosition - FVector2D(GuideBoxOffset.Left, GuideBoxOffset.Top);
-		const FVector2D GuideWidgetSize = GuideSize + FVector2D(GuideBoxOffset.Left + GuideBoxOffset.Right, GuideBoxOffset.Top + GuideBoxOffset.Bottom);
+		FVector2D GuideWidgetPosition;
+		FVector2D GuideWidgetSize;
+		GetGuideBoxRect(GuideBoxOffset, ScreenPosition, GuideSize, GuideWidgetPosition, GuideWidgetSize);
 
 		FVector2D WidgetLeftTop = FVector2D(GuideWidgetPosition.X + GuideWidgetSize.X * 0.5f, GuideWidgetPosition.Y + GuideWidgetSize.Y * 0.5f);
 		FVector2D WidgetCenter_Pixel = WidgetLeftTop;
@@ -361,20 +771,349 @@ void UGuideLayerBase::SynchronizeProperties()
 		FVector2D SizeUV = WidgetSize_Pixel / FVector2D(1920, 1080);
 
 		// 머티리얼 파라미터로 넘기기
-		if (ensure(MaterialInstance))
+		MaskParameters.SetVector(FGuideMaskParameterBlock::EVector::Center, FLinearColor(CenterUV.X, CenterUV.Y, 0, 0));
+		MaskParameters.SetVector(FGuideMaskParameterBlock::EVector::Size, FLinearColor(SizeUV.X, SizeUV.Y, 0, 0));
+		RequestMaskFlush();
+	}
+#endif
+}
+
+void UGuideLayerBase::RemoveFromParent()
+{
+	NotifyGuideFinished();
+
+	if (UGuideLayerHostSubsystem* Host = UGuideLayerHostSubsystem::Get(this))
+	{
+		if (true == Host->RemoveLayer(this))
 		{
-			MaterialInstance->SetVectorParameterValue("Center", FLinearColor(CenterUV.X, CenterUV.Y, 0, 0));
-			MaterialInstance->SetVectorParameterValue("Size", FLinearColor(SizeUV.X, SizeUV.Y, 0, 0));
+			return;
 		}
 	}
+
+	Super::RemoveFromParent();
+}
+
+void UGuideLayerBase::OnResizedViewport(FViewport* InViewport, uint32 InMessage)
+{
+	bSafeRectDirty = true;
+
+	if (true == IsTrackingWorldTarget())
+	{
+		// The previous rect is in old screen UVs.
+		StopTransition();
+
+		bHasProjectedRect = false;
+		UpdateWorldTarget();
+	}
+
+	else if (true == GuideWidget.IsValid())
+	{
+		StopTransition();
+
+		SetGuideInternal(GetGuideViewportGeometry(), GuideWidget.Get());
+	}
+}
+
+void UGuideLayerBase::OnSafeFrameChanged()
+{
+	// Rotation or a debug safe zone change, the guide is placed again like after a resize.
+	OnResizedViewport(nullptr, 0);
+}
+
+void UGuideLayerBase::InvalidateMask()
+{
+	// Nothing on the layer ticks or is volatile, the mask animation runs on material time.
+	// A parameter change only repaints the black screen.
+	if (nullptr == BlackScreen)
+	{
+		return;
+	}
+
+	if (TSharedPtr<SWidget> ImageWidget = BlackScreen->GetCachedWidget())
+	{
+		ImageWidget->Invalidate(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UGuideLayerBase::RequestMaskFlush()
+{
+	if (false == MaskParameters.IsDirty() || MaskFlushHandle.IsValid())
+	{
+		return;
+	}
+
+	if (false == FSlateApplication::IsInitialized())
+	{
+		FlushMaskParameters();
+		return;
+	}
+
+	MaskFlushHandle = FSlateApplication::Get().OnPreTick().AddUObject(this, &UGuideLayerBase::OnPreTickFlush);
+}
+
+void UGuideLayerBase::FlushMaskParameters()
+{
+	if (true == MaskParameters.Flush(MaterialInstance))
+	{
+		InvalidateMask();
+	}
+}
+
+void UGuideLayerBase::OnPreTickFlush(float InDeltaTime)
+{
+	FSlateApplication::Get().OnPreTick().Remove(MaskFlushHandle);
+	MaskFlushHandle.Reset();
+
+	FlushMaskParameters();
+}
+
+void UGuideLayerBase::StartTransition(const FLinearColor& InFromCenter, const FLinearColor& InFromSize)
+{
+	StopTransition();
+
+	TransitionStartTime = FApp::GetCurrentTime() - GStartTime;
+
+	MaskParameters.SetVector(FGuideMaskParameterBlock::EVector::PrevCenter, InFromCenter);
+	MaskParameters.SetVector(FGuideMaskParameterBlock::EVector::PrevSize, InFromSize);
+	MaskParameters.SetScalar(FGuideMaskParameterBlock::EScalar::TransitionStartTime, (float)TransitionStartTime);
+	MaskParameters.SetScalar(FGuideMaskParameterBlock::EScalar::TransitionDuration, TransitionDuration);
+	RequestMaskFlush();
+
+	// Completion is only reported, the GPU already stopped moving the cutout.
+#if ENGINE_MAJOR_VERSION >= 5
+	TransitionTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideLayerBase::OnTransitionElapsed), TransitionDuration);
+#else
+	TransitionTickerHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &UGuideLayerBase::OnTransitionElapsed), TransitionDuration);
+#endif
+}
+
+void UGuideLayerBase::StopTransition()
+{
+	if (TransitionTickerHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(TransitionTickerHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(TransitionTickerHandle);
 #endif
+
+		TransitionTickerHandle.Reset();
+	}
+
+	MaskParameters.SetScalar(FGuideMaskParameterBlock::EScalar::TransitionDuration, 0.f);
+	RequestMaskFlush();
 }
 
+bool UGuideLayerBase::OnTransitionElapsed(float InDeltaTime)
+{
+	TransitionTickerHandle.Reset();
 
-void UGuideLayerBase::OnResizedViewport(FViewport* InViewport, uint32 InMessage)
+	MaskParameters.SetScalar(FGuideMaskParameterBlock::EScalar::TransitionDuration, 0.f);
+	RequestMaskFlush();
+
+	OnTransitionFinished.Broadcast();
+
+	return false;
+}
+
+void UGuideLayerBase::GetDisplayedRect(FLinearColor& OutCenter, FLinearColor& OutSize) const
 {
-	if (true == GuideWidget.IsValid())
+	OutCenter = MaskParameters.GetVector(FGuideMaskParameterBlock::EVector::Center);
+	OutSize = MaskParameters.GetVector(FGuideMaskParameterBlock::EVector::Size);
+
+	if (false == IsTransitioning() || TransitionDuration <= 0.f)
 	{
-		SetGuideInternal(UWidgetLayoutLibrary::GetViewportWidgetGeometry(GetWorld()), GuideWidget.Get());
+		return;
+	}
+
+	// Retargeted mid-way, start from where the material currently draws the cutout.
+	const float Alpha = FMath::Clamp((float)((FApp::GetCurrentTime() - GStartTime - TransitionStartTime) / TransitionDuration), 0.f, 1.f);
+
+	OutCenter = FMath::Lerp(MaskParameters.GetVector(FGuideMaskParameterBlock::EVector::PrevCenter), OutCenter, Alpha);
+	OutSize = FMath::Lerp(MaskParameters.GetVector(FGuideMaskParameterBlock::EVector::PrevSize), OutSize, Alpha);
+}
+
+bool UGuideLayerBase::IsTrackingWorldTarget() const
+{
+	return WorldTickHandle.IsValid();
+}
+
+void UGuideLayerBase::StartWorldTracking()
+{
+	bHasProjectedRect = false;
+
+	UpdateWorldTarget();
+
+	if (false == WorldTickHandle.IsValid())
+	{
+		WorldTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UGuideLayerBase::OnWorldPostActorTick);
+	}
+}
+
+void UGuideLayerBase::StopWorldTracking()
+{
+	if (WorldTickHandle.IsValid())
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(WorldTickHandle);
+		WorldTickHandle.Reset();
+	}
+
+	GuideActor.Reset();
+	GuideComponent.Reset();
+	GuideWidgetComponent.Reset();
+	bHasProjectedRect = false;
+
+	// The next guide sets the cutout and the box itself.
+	bWorldTargetHidden = false;
+	bBoxHiddenWithTarget = false;
+}
+
+void UGuideLayerBase::OnWorldPostActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+	// Runs after the camera update, so the projection matches the frame being drawn.
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	const bool bWidgetTarget = GuideWidgetComponent.IsValid() && GuideWidget.IsValid();
+	if (false == bWidgetTarget && false == GuideActor.IsValid() && false == GuideComponent.IsValid())
+	{
+		StopWorldTracking();
+		return;
+	}
+
+	SetWorldTargetHidden(false == UpdateWorldTarget());
+}
+
+void UGuideLayerBase::SetWorldTargetHidden(bool bInHidden)
+{
+	if (bInHidden == bWorldTargetHidden)
+	{
+		return;
+	}
+
+	bWorldTargetHidden = bInHidden;
+
+	if (true == bInHidden)
+	{
+		// No hole over empty space, the next successful projection applies the rect again.
+		StopTransition();
+		bHasProjectedRect = false;
+
+		MaskParameters.SetVector(FGuideMaskParameterBlock::EVector::Size, FLinearColor(0, 0, 0, 0));
+		RequestMaskFlush();
+
+		bBoxHiddenWithTarget = nullptr != GuideBoxPanel && ESlateVisibility::Collapsed != GuideBoxPanel->GetVisibility();
+		if (true == bBoxHiddenWithTarget)
+		{
+			GuideBoxPanel->SetVisibility(ESlateVisibility::Collapsed);
+		}
+	}
+
+	else if (true == bBoxHiddenWithTarget)
+	{
+		bBoxHiddenWithTarget = false;
+
+		if (nullptr != GuideBoxPanel)
+		{
+			GuideBoxPanel->SetVisibility(ESlateVisibility::SelfHitTestInvisible);
+		}
+	}
+}
+
+bool UGuideLayerBase::UpdateWorldTarget()
+{
+	FGuideViewProjection Projection;
+	if (false == FGuideViewProjection::Get(GetOwningPlayer(), Projection))
+	{
+		return false;
+	}
+
+	FVector2D Position;
+	FVector2D Size;
+
+	if (UWidgetComponent* WidgetComponent = GuideWidgetComponent.Get())
+	{
+		FVector Corners[4];
+		if (false == FGuideWidgetComponentSpace::GetWorldCorners(WidgetComponent, GuideWidget.Get(), Corners)
+			|| false == Projection.ProjectPoints(TArrayView<const FVector>(Corners, 4), Position, Size))
+		{
+			return false;
+		}
 	}
+
+	else
+	{
+		FBox Bounds(ForceInit);
+
+		if (USceneComponent* Component = GuideComponent.Get())
+		{
+			Bounds = Component->Bounds.GetBox();
+		}
+
+		else if (AActor* Actor = GuideActor.Get())
+		{
+			Bounds = Actor->GetComponentsBoundingBox(true);
+		}
+
+		if (false == Projection.ProjectBox(Bounds, Position, Size))
+		{
+			return false;
+		}
+	}
+
+	// Same rect as last frame, nothing to push.
+	if (true == bHasProjectedRect && Position.Equals(ProjectedPosition, 0.5f) && Size.Equals(ProjectedSize, 0.5f))
+	{
+		return true;
+	}
+
+	bHasProjectedRect = true;
+	ProjectedPosition = Position;
+	ProjectedSize = Size;
+
+	ApplyGuideRect(GetGuideViewportGeometry(), ProjectedPosition, ProjectedSize);
+
+	return true;
+}
+
+UPrimitiveComponent* UGuideLayerBase::GetWorldTargetPrimitive() const
+{
+	if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(GuideComponent.Get()))
+	{
+		return Primitive;
+	}
+
+	AActor* Actor = GuideActor.Get();
+	if (nullptr == Actor)
+	{
+		return nullptr;
+	}
+
+	if (UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(Actor->GetRootComponent()))
+	{
+		return RootPrimitive;
+	}
+
+	return Actor->FindComponentByClass<UPrimitiveComponent>();
+}
+
+void UGuideLayerBase::HandleActionCompleted()
+{
+	OnEndGuide();
+	NotifyGuideFinished();
+}
+
+void UGuideLayerBase::NotifyGuideFinished()
+{
+	if (false == bGuideActive)
+	{
+		return;
+	}
+
+	bGuideActive = false;
+	OnGuideFinished.Broadcast(this);
 }
@@ -12,9 +12,84 @@ class UCanvasPanel;
 class UImage;
 
 class UGuideBoxBase;
+class UMaterialInstanceDynamic;
+class AActor;
+class USceneComponent;
+class UPrimitiveComponent;
+class UWidgetComponent;
 struct FGuideBoxActionParameters;
 
-UCLASS()
+/**
+ * Mask material parameters of a layer.
+ * Setters only record values, Flush writes the changed ones through cached parameter indices.
+ */
+struct GUIDEMASKUI_API FGuideMaskParameterBlock
+{
+public:
+	enum class EScalar : uint8
+	{
+		Animate,
+		AnimSpeed,
+		Shape,
+		Opacity,
+		TransitionStartTime,
+		TransitionDuration,
+
+		Max,
+	};
+
+	enum class EVector : uint8
+	{
+		Center,
+		Size,
+		PrevCenter,
+		PrevSize,
+
+		Max,
+	};
+
+	void SetScalar(EScalar InParam, float InValue);
+	void SetVector(EVector InParam, const FLinearColor& InValue);
+
+	float GetScalar(EScalar InParam) const { return Scalars[(uint8)InParam]; }
+	const FLinearColor& GetVector(EVector InParam) const { return Vectors[(uint8)InParam]; }
+
+	bool IsDirty() const { return 0 != DirtyScalars || 0 != DirtyVectors; }
+
+	/** Returns true if anything was written to the material. */
+	bool Flush(UMaterialInstanceDynamic* InMaterial);
+
+private:
+	void Bind(UMaterialInstanceDynamic* InMaterial);
+
+	static const FName ScalarNames[(uint8)EScalar::Max];
+	static const FName VectorNames[(uint8)EVector::Max];
+
+private:
+	TWeakObjectPtr<UMaterialInstanceDynamic> BoundMaterial;
+
+	float Scalars[(uint8)EScalar::Max] = {};
+	float WrittenScalars[(uint8)EScalar::Max] = {};
+	int32 ScalarIndices[(uint8)EScalar::Max] = {};
+
+	FLinearColor Vectors[(uint8)EVector::Max];
+	FLinearColor WrittenVectors[(uint8)EVector::Max];
+	int32 VectorIndices[(uint8)EVector::Max] = {};
+
+	// Bit per parameter, set while the recorded value differs from the written one.
+	uint32 DirtyScalars = 0;
+	uint32 DirtyVectors = 0;
+
+	// Bit per parameter, set once it was written to the bound material.
+	uint32 WrittenScalarMask = 0;
+	uint32 WrittenVectorMask = 0;
+};
+
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnGuideTransitionFinished);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGuideFinishedNative, UGuideLayerBase*);
+
+UCLASS(meta = (DisableNativeTick))
 class GUIDEMASKUI_API UGuideLayerBase : public UUserWidget
 {
 	GENERATED_BODY()
@@ -23,6 +98,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
 	void SetGuide(UWidget* InWidget, const FGuideBoxActionParameters& InParameter);
 
+	/** Cuts out the screen rect of the actor's bounds, projected again every frame until another guide is set. */
+	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
+	void SetGuideActor(AActor* InActor, const FGuideBoxActionParameters& InParameter);
+
+	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
+	void SetGuideComponent(USceneComponent* InComponent, const FGuideBoxActionParameters& InParameter);
+
 
 	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
 	FVector2D GetWidgetPosition() const;
@@ -30,6 +112,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
 	FVector2D GetWidgetSize() const;
 
+	/**
+	 * Part of the layer outside the device safe zone (notches, rounded corners, TV overscan), in layer space.
+	 * Callouts placed inside it stay visible. False until the layer was laid out once.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
+	bool GetSafeRect(FVector2D& OutPosition, FVector2D& OutSize);
+
 
 	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
 	void SetEnableAnim(bool bIsEnable);
@@ -59,6 +148,43 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
 	void SetBoxOffset(const FMargin& InMargin);
 
+
+	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
+	void SetTransitionDuration(float InDuration);
+
+	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
+	float GetTransitionDuration() const;
+
+	UFUNCTION(BlueprintCallable, Category = "GuideLayerBase")
+	bool IsTransitioning() const;
+
+	/** Called when the cutout reached the new target after SetGuide on a layer that already showed one. */
+	UPROPERTY(BlueprintAssignable, Category = "GuideLayerBase|Events")
+	FOnGuideTransitionFinished OnTransitionFinished;
+
+	/** Once per guide, when its action completed or the layer was removed. */
+	FOnGuideFinishedNative OnGuideFinished;
+
+	bool IsGuideActive() const { return bGuideActive; }
+
+	/** Ends the current guide and forgets its target, used before the layer goes back to the host's pool. */
+	void ResetGuide();
+
+	// Guide rect math, shared with the offline layout check.
+
+	/** Rect of a laid out widget in the space of the viewport geometry. */
+	static void GetGeometryViewportRect(const FGeometry& InViewportGeometry, const FGeometry& InWidgetGeometry, FVector2D& OutPosition, FVector2D& OutSize);
+
+	/** Guide box around a target rect, grown by the box offset. The cutout is centered on it. */
+	static void GetGuideBoxRect(const FMargin& InBoxOffset, const FVector2D& InTargetPosition, const FVector2D& InTargetSize, FVector2D& OutPosition, FVector2D& OutSize);
+
+	/** Keeps the box offset out of the safe rect's margins. The target itself is never cut. */
+	static void ClampGuideBoxRect(const FVector2D& InSafePosition, const FVector2D& InSafeSize, const FVector2D& InTargetPosition, const FVector2D& InTargetSize,
+		FVector2D& InOutPosition, FVector2D& InOutSize);
+
+	/** Safe rect in viewport widget space from a safe zone margin in viewport pixels. */
+	static void GetViewportSafeRect(const FMargin& InSafeMargin, const FVector2D& InViewportSize, float InViewportScale, FVector2D& OutPosition, FVector2D& OutSize);
+
 #if WITH_EDITOR
 public:
 	void SetPreviewGuide(const FGeometry& InViewportGeometry, UWidget* InWidget);
@@ -75,10 +201,19 @@ public:
 protected:
 	virtual void SetGuideInternal(const FGeometry& InViewportGeometry, UWidget* InWidget);
 
+	// Places the cutout and the guide box on a rect in viewport widget space.
+	void ApplyGuideRect(const FGeometry& InViewportGeometry, const FVector2D& InTargetPosition, const FVector2D& InTargetSize);
+
+	static bool GetWidgetViewportRect(const FGeometry& InViewportGeometry, const UWidget* InWidget, FVector2D& OutPosition, FVector2D& OutSize);
+
+	// The owning player's split-screen region, or the whole viewport for a layer without a player.
+	FGeometry GetGuideViewportGeometry() const;
+
 protected:
+	/** InSafePosition and InSafeSize are the safe rect of GetSafeRect, zero size if the layer wasn't laid out yet. */
 	UFUNCTION(BlueprintNativeEvent, meta = (DisplayName = "On Start Action"))
-	void OnStartGuide(UWidget* InWidget, const FGuideBoxActionParameters& InParam);
-	virtual void OnStartGuide_Implementation(UWidget* InWidget, const FGuideBoxActionParameters& InParam) {};
+	void OnStartGuide(UWidget* InWidget, const FGuideBoxActionParameters& InParam, const FVector2D& InSafePosition, const FVector2D& InSafeSize);
+	virtual void OnStartGuide_Implementation(UWidget* InWidget, const FGuideBoxActionParameters& InParam, const FVector2D& InSafePosition, const FVector2D& InSafeSize) {};
 
 	UFUNCTION(BlueprintNativeEvent, meta = (DisplayName = "On End Action"))
 	void OnEndGuide();
@@ -98,8 +233,47 @@ protected:
 
 	virtual void SynchronizeProperties() override;
 
+public:
+	// Hosted layers live in a slot of the player's guide host, not in the viewport.
+	virtual void RemoveFromParent() override;
+
 private:
 	void OnResizedViewport(FViewport* InViewport, uint32 InMessage);
+	void OnSafeFrameChanged();
+	bool RefreshSafeRect();
+	void InvalidateMask();
+
+	// Several setters in one frame end up in a single flush before slate paints.
+	void RequestMaskFlush();
+	void FlushMaskParameters();
+	void OnPreTickFlush(float InDeltaTime);
+
+	/**
+	 * The material interpolates the cutout from PrevCenter/PrevSize to Center/Size with
+	 * saturate((Time - TransitionStartTime) / TransitionDuration), no tick on the CPU side.
+	 */
+	void StartTransition(const FLinearColor& InFromCenter, const FLinearColor& InFromSize);
+	void StopTransition();
+	bool OnTransitionElapsed(float InDeltaTime);
+	void GetDisplayedRect(FLinearColor& OutCenter, FLinearColor& OutSize) const;
+
+	void SetGuideWorldTarget(AActor* InActor, USceneComponent* InComponent, const FGuideBoxActionParameters& InParameter);
+	// Creates the box on the first guide that takes input. False if the panel can't hold one.
+	bool EnsureGuideBox();
+	void StartGuide(UWidget* InWidget, const FGuideBoxActionParameters& InParameter, bool bInTransition, const FLinearColor& InFromCenter, const FLinearColor& InFromSize);
+
+	bool IsTrackingWorldTarget() const;
+	void StartWorldTracking();
+	void StopWorldTracking();
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+	bool UpdateWorldTarget();
+	// While the target can't be projected (behind the camera) the cutout and the box are taken away.
+	void SetWorldTargetHidden(bool bInHidden);
+	UPrimitiveComponent* GetWorldTargetPrimitive() const;
+
+	UFUNCTION()
+	void HandleActionCompleted();
+	void NotifyGuideFinished();
 	
 protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintSetter = SetOpacity, BlueprintGetter = GetOpacity, meta = (Category = "Layer Setting", AllowPrivateAccess = "true", ClampMin = "0", ClampMax = "1"))
@@ -114,6 +288,10 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintSetter = SetBoxOffset, BlueprintGetter = GetBoxOffset, meta = (Category = "Layer Setting", AllowPrivateAccess = "true"))
 	FMargin GuideBoxOffset;
 
+	// Seconds the cutout takes to move to the next target. 0 jumps.
+	UPROPERTY(EditDefaultsOnly, BlueprintSetter = SetTransitionDuration, BlueprintGetter = GetTransitionDuration, meta = (Category = "Layer Setting", AllowPrivateAccess = "true", ClampMin = "0"))
+	float TransitionDuration = 0.f;
+
 
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(EditDefaultsOnly, meta = (Category = "Preview Layer Setting", AllowPrivateAccess = "true"))
@@ -139,8 +317,41 @@ protected:
 	UPROPERTY()
 	UMaterialInstanceDynamic* MaterialInstance = nullptr;
 
+	FGuideMaskParameterBlock MaskParameters;
+	FDelegateHandle MaskFlushHandle;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle TransitionTickerHandle;
+#else
+	FDelegateHandle TransitionTickerHandle;
+#endif
+
+	// Material time (seconds since start) the running transition began at.
+	double TransitionStartTime = 0.0;
+	bool bHasGuideRect = false;
+	bool bGuideActive = false;
+
 	UPROPERTY(Transient)
 	UGuideBoxBase* BoxBaseWidget = nullptr;
 
 	TWeakObjectPtr<UWidget> GuideWidget = nullptr;
+
+	TWeakObjectPtr<AActor> GuideActor = nullptr;
+	TWeakObjectPtr<USceneComponent> GuideComponent = nullptr;
+
+	// Set when GuideWidget is drawn by a world space widget component.
+	TWeakObjectPtr<UWidgetComponent> GuideWidgetComponent = nullptr;
+	FDelegateHandle WorldTickHandle;
+
+	// Last projected rect of the world target, the mask is only touched when it moves.
+	FVector2D ProjectedPosition = FVector2D::ZeroVector;
+	FVector2D ProjectedSize = FVector2D::ZeroVector;
+	bool bHasProjectedRect = false;
+	bool bWorldTargetHidden = false;
+	bool bBoxHiddenWithTarget = false;
+
+	// Safe rect in layer space. Rebuilt on the next use after a safe frame change or a resize, never per frame.
+	FVector2D SafePosition = FVector2D::ZeroVector;
+	FVector2D SafeSize = FVector2D::ZeroVector;
+	bool bSafeRectDirty = true;
 };
@@ -12,6 +12,7 @@
 
 #include "../EntryGuideIdentifiable.h"
 #include "../GuideMaskUIFunctionLibrary.h"
+#include "../GuideMaskRegistrySubsystem.h"
 
 #include "Runtime/Launch/Resources/Version.h"
 
@@ -27,23 +28,18 @@
 
 void UGuideMaskRegister::HidePreviewDebug()
 {
-	if (nullptr != LayerContent)
-	{
-		if (Overlay)
-		{
-			Overlay->RemoveSlot(LayerContent->TakeWidget());
-		}
+	bShowPreview = false;
 
-		LayerContent->RemoveFromParent();
-		LayerContent = nullptr;
+	// The layer is kept for the next "Show Preview", only hidden.
+	if (nullptr != PreviewLayer)
+	{
+		PreviewLayer->SetVisibility(ESlateVisibility::Collapsed);
 	}
 }
 
 void UGuideMaskRegister::ShowPreviewDebug()
 {
-	HidePreviewDebug();
-
-	ForceLayoutPrepass();
+	bShowPreview = true;
 
 	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
 	if (ensureAlways(Settings))
@@ -54,106 +50,192 @@ void UGuideMaskRegister::ShowPreviewDebug()
 			return;
 		}
 
-		UWidget* ContentWidget = GetContent();
-		if (ContentWidget && ContentWidget->GetCachedWidget())
+		// Already loaded, no streaming request needed.
+		if (UClass* LoadedClass = Settings->DefaultLayer.Get())
 		{
-			FStreamableManager& StreamableManager = UAssetManager::Get().GetStreamableManager();
-			TSharedPtr<FStreamableHandle> StreamingHandle = StreamableManager.RequestAsyncLoad(Settings->DefaultLayer.ToSoftObjectPath(), FStreamableDelegate::CreateWeakLambda(this,
-				[this, Geometry = ContentWidget->GetCachedWidget()->GetTickSpaceGeometry()]()
-				{
-					CreatePreviewLayer(Geometry);
-				}));
+			SetPreviewLayerClass(LoadedClass);
+			RefreshPreviewLayer();
+			return;
 		}
+
+		if (true == bPreviewLayerLoading)
+		{
+			return;
+		}
+
+		bPreviewLayerLoading = true;
+
+		FStreamableManager& StreamableManager = UAssetManager::Get().GetStreamableManager();
+		StreamableManager.RequestAsyncLoad(Settings->DefaultLayer.ToSoftObjectPath(), FStreamableDelegate::CreateWeakLambda(this,
+			[this]()
+			{
+				bPreviewLayerLoading = false;
+
+				if (const UGuideMaskSettings* LoadedSettings = GetDefault<UGuideMaskSettings>())
+				{
+					SetPreviewLayerClass(LoadedSettings->DefaultLayer.Get());
+					RefreshPreviewLayer();
+				}
+			}));
 	}
 }
 
-void UGuideMaskRegister::CreatePreviewLayer(const FGeometry& InViewportGeometry)
+void UGuideMaskRegister::SetPreviewLayerClass(TSubclassOf<UGuideLayerBase> InLayerClass)
 {
-	const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>();
-	if (!ensureAlways(Settings))
+	if (PreviewLayerClass == InLayerClass)
 	{
 		return;
 	}
 
-	UGuideLayerBase* Layer = CreateWidget<UGuideLayerBase>(GetWorld(), Settings->DefaultLayer.Get());
-	if (nullptr == Layer)
+	// Layer class changed in the project settings, the old layer can't be reused.
+	if (nullptr != PreviewLayer)
 	{
-		return;
+		if (Overlay && LayerContent == PreviewLayer)
+		{
+			Overlay->RemoveSlot(PreviewLayer->TakeWidget());
+			LayerContent = nullptr;
+		}
+
+		PreviewLayer = nullptr;
 	}
 
-	if (false == TagWidgetList.Contains(PreviewTag))
+	PreviewLayerClass = InLayerClass;
+}
+
+void UGuideMaskRegister::RefreshPreviewLayer()
+{
+	if (false == bShowPreview || nullptr == PreviewLayerClass)
 	{
 		return;
 	}
 
-	UWidget* TagWidget = TagWidgetList[PreviewTag];
-	if (nullptr == TagWidget)
+	UWidget* ContentWidget = GetContent();
+	if (nullptr == ContentWidget || false == ContentWidget->GetCachedWidget().IsValid())
 	{
 		return;
 	}
 
-	UWidget* Target = nullptr;
-
-	TArray<FGuideHierarchyNode> Tree;
-	ConstructWidgetTree(OUT Tree, TagWidget);
-
-
-	for (int i = 0; i < Tree.Num(); ++i)
+	UWidget* Target = ResolvePreviewTarget();
+	if (nullptr == Target)
 	{
-		UWidget* ScopeWidget = Tree[i].Container;
-		if (nullptr == ScopeWidget)
+		// Tag or widget no longer exists, don't leave the old highlight up.
+		if (nullptr != PreviewLayer)
 		{
-			continue;
+			PreviewLayer->SetVisibility(ESlateVisibility::Collapsed);
 		}
 
-		if (ScopeWidget->GetFName().IsEqual(PreviewWidget))
+		return;
+	}
+
+	if (nullptr == PreviewLayer)
+	{
+		PreviewLayer = CreateWidget<UGuideLayerBase>(GetWorld(), PreviewLayerClass);
+		if (nullptr == PreviewLayer)
 		{
-			Target = ScopeWidget;
-			break;
+			return;
 		}
+	}
 
-		int Index = Tree[i].Children.IndexOfByPredicate([this](UWidget* InChild)
-			{
-				return InChild && InChild->GetFName().IsEqual(PreviewWidget);
-			});
+	if (LayerContent != PreviewLayer)
+	{
+		SetLayer(PreviewLayer);
+	}
 
-		if (INDEX_NONE != Index)
-		{
-			Target = Tree[i].Children[Index];
-			break;
-		}
+	PreviewLayer->SetVisibility(ESlateVisibility::Visible);
+
+	ForceLayoutPrepass();
+	PreviewLayer->SetPreviewGuide(ContentWidget->GetCachedWidget()->GetTickSpaceGeometry(), Target);
+}
+
+UWidget* UGuideMaskRegister::ResolvePreviewTarget() const
+{
+	UWidget* TagWidget = TagWidgetList.FindRef(PreviewTag);
+	if (nullptr == TagWidget)
+	{
+		return nullptr;
 	}
 
+	UWidget* Target = PreviewNameIndex.FindRef(PreviewWidget).Get();
 	if (nullptr == Target)
 	{
 		Target = TagWidget;
 	}
 
-	if (nullptr != Target)
-	{
-		SetLayer(Layer);
+	UWidget* TargetWidget = nullptr;
 
-		UWidget* TargetWidget = nullptr;
-
-		if (UListViewBase* ListView = Cast<UListViewBase>(Target))
-		{
+	if (UListViewBase* ListView = Cast<UListViewBase>(Target))
+	{
 #if ENGINE_MAJOR_VERSION >= 5
-			TargetWidget = false == ListView->GetDisplayedEntryWidgets().IsEmpty() ? *ListView->GetDisplayedEntryWidgets().begin() : nullptr;
+		TargetWidget = false == ListView->GetDisplayedEntryWidgets().IsEmpty() ? *ListView->GetDisplayedEntryWidgets().begin() : nullptr;
 #else
-			TargetWidget = 0 < ListView->GetDisplayedEntryWidgets().Num() ? *ListView->GetDisplayedEntryWidgets().begin() : nullptr;
+		TargetWidget = 0 < ListView->GetDisplayedEntryWidgets().Num() ? *ListView->GetDisplayedEntryWidgets().begin() : nullptr;
 #endif
-		}
+	}
 
-		else if (UDynamicEntryBox* EntryBox = Cast<UDynamicEntryBox>(Target))
-		{
+	else if (UDynamicEntryBox* EntryBox = Cast<UDynamicEntryBox>(Target))
+	{
 #if ENGINE_MAJOR_VERSION >= 5
-			TargetWidget = false == EntryBox->GetAllEntries().IsEmpty() ? *EntryBox->GetAllEntries().begin() : nullptr;
+		TargetWidget = false == EntryBox->GetAllEntries().IsEmpty() ? *EntryBox->GetAllEntries().begin() : nullptr;
 #else
-			TargetWidget = 0 < EntryBox->GetAllEntries().Num() ? *EntryBox->GetAllEntries().begin() : nullptr;
+		TargetWidget = 0 < EntryBox->GetAllEntries().Num() ? *EntryBox->GetAllEntries().begin() : nullptr;
 #endif
+	}
+
+	return nullptr != TargetWidget ? TargetWidget : Target;
+}
+
+void UGuideMaskRegister::RefreshPreviewHierarchy()
+{
+	// ConstructWidgetTree may instantiate entry widgets, so rebuild only when the preview tag or its containers changed.
+	const uint32 HierarchyHash = GetPreviewHierarchyHash();
+	if (HierarchyHash == CachedHierarchyHash)
+	{
+		return;
+	}
+
+	WidgetHierarchy.Reset();
+	if (TagWidgetList.Contains(PreviewTag))
+	{
+		UWidget* Widget = TagWidgetList.FindRef(PreviewTag);
+		ConstructWidgetTree(OUT WidgetHierarchy, Widget);
+	}
+
+	// Containers were read before the rebuild, hash again so the next sync compares against the new tree.
+	CachedHierarchyHash = GetPreviewHierarchyHash();
+
+	RebuildPreviewNameIndex();
+	OnPreviewHierarchyChanged.Broadcast();
+}
+
+void UGuideMaskRegister::RebuildPreviewNameIndex()
+{
+	PreviewNameIndex.Reset();
+
+	if (UWidget* TagWidget = TagWidgetList.FindRef(PreviewTag))
+	{
+		PreviewNameIndex.Emplace(TagWidget->GetFName(), TagWidget);
+	}
+
+	// Same order the tree used to be searched in, so the first match by name still wins.
+	for (const FGuideHierarchyNode& Node : WidgetHierarchy)
+	{
+		if (nullptr == Node.Container)
+		{
+			continue;
+		}
+
+		if (false == PreviewNameIndex.Contains(Node.Container->GetFName()))
+		{
+			PreviewNameIndex.Emplace(Node.Container->GetFName(), Node.Container);
 		}
 
-		Layer->SetPreviewGuide(InViewportGeometry, nullptr != TargetWidget ? TargetWidget : Target);
+		for (UWidget* Child : Node.Children)
+		{
+			if (nullptr != Child && false == PreviewNameIndex.Contains(Child->GetFName()))
+			{
+				PreviewNameIndex.Emplace(Child->GetFName(), Child);
+			}
+		}
 	}
 }
 
@@ -180,18 +262,12 @@ TArray<FName> UGuideMaskRegister::GetTagOptions() const
 TArray<FName> UGuideMaskRegister::GetNestedWidgetOptions() const
 {
 	TArray<FName> NameList;
-	TArray<FGuideHierarchyNode> NewTree;
-	UWidget* TagWidget = nullptr;
+	UWidget* TagWidget = TagWidgetList.FindRef(PreviewTag);
 
-	if (TagWidgetList.Contains(PreviewTag))
-	{
-		TagWidget = TagWidgetList[PreviewTag];
-		ConstructWidgetTree(OUT NewTree, TagWidget);
-	}
-
-	for (int i = 0; i < NewTree.Num(); ++i)
+	// The hierarchy of the preview tag is kept by the designer sync, building it here would instantiate entries on every query.
+	for (int i = 0; i < WidgetHierarchy.Num(); ++i)
 	{
-		FGuideHierarchyNode Node = NewTree[i];
+		const FGuideHierarchyNode& Node = WidgetHierarchy[i];
 
 		if (nullptr == Node.Container)
 		{
@@ -265,6 +341,34 @@ void UGuideMaskRegister::ValidateCompiledDefaults(IWidgetCompilerLog& CompileLog
 	}
 
 
+	TSet<FGameplayTag> MappedTags;
+
+	for (const auto& Pair : GameplayTags)
+	{
+		if (false == TagWidgetList.Contains(Pair.Key))
+		{
+			CompileLog.Error(FText::Format(LOCTEXT("GuideMaskRegister",
+				"Gameplay tag {0} is mapped to {1}, which is not in TagWidgetList!"),
+				FText::FromString(Pair.Value.ToString()), FText::FromName(Pair.Key)));
+		}
+
+		if (false == Pair.Value.IsValid())
+		{
+			continue;
+		}
+
+		bool bAlreadyMapped = false;
+		MappedTags.Add(Pair.Value, &bAlreadyMapped);
+
+		if (true == bAlreadyMapped)
+		{
+			CompileLog.Error(FText::Format(LOCTEXT("GuideMaskRegister",
+				"Gameplay tag {0} is mapped to more than one tag!"),
+				FText::FromString(Pair.Value.ToString())));
+		}
+	}
+
+
 	for (auto& Pair : TagWidgetList)
 	{
 		FName Tag = Pair.Key;
@@ -327,6 +431,9 @@ void UGuideMaskRegister::PostEditChangeProperty(FPropertyChangedEvent& PropertyC
 
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(UGuideMaskRegister, PreviewTag))
 	{
+		// Already rebuilt by SynchronizeProperties, a no-op then.
+		RefreshPreviewHierarchy();
+
 		TArray<FName> NestedWidgetList = GetNestedWidgetOptions();
 
 #if ENGINE_MAJOR_VERSION >= 5
@@ -340,6 +447,14 @@ void UGuideMaskRegister::PostEditChangeProperty(FPropertyChangedEvent& PropertyC
 	{
 		TArray<FName> TagList = GetTagOptions();
 
+		for (auto Itr = GameplayTags.CreateIterator(); Itr; ++Itr)
+		{
+			if (false == TagList.Contains(Itr.Key()))
+			{
+				Itr.RemoveCurrent();
+			}
+		}
+
 		if (false == TagList.Contains(PreviewTag))
 		{
 #if ENGINE_MAJOR_VERSION >= 5
@@ -348,6 +463,8 @@ void UGuideMaskRegister::PostEditChangeProperty(FPropertyChangedEvent& PropertyC
 			PreviewTag = 0 < TagList.Num() ? *TagList.begin() : FName();
 #endif
 
+			RefreshPreviewHierarchy();
+
 			TArray<FName> WidgetList = GetNestedWidgetOptions();
 
 #if ENGINE_MAJOR_VERSION >= 5
@@ -357,6 +474,14 @@ void UGuideMaskRegister::PostEditChangeProperty(FPropertyChangedEvent& PropertyC
 #endif
 		}
 	}
+
+	// Follow the preview selection live while the preview is shown.
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UGuideMaskRegister, PreviewTag) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(UGuideMaskRegister, PreviewWidget) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(UGuideMaskRegister, TagWidgetList))
+	{
+		RefreshPreviewLayer();
+	}
 }
 
 
@@ -371,6 +496,7 @@ void UGuideMaskRegister::ConstructWidgetTree(OUT TArray<FGuideHierarchyNode>& Ou
 	TSubclassOf<UUserWidget> EntryClass = nullptr;
 	TArray<UUserWidget*> EntryList;
 
+	// UTreeView and UTileView included, every entry of a tree shares the one entry class.
 	if (UListView* ListView = Cast<UListView>(InWidget))
 	{
 		NewNode.Container = InWidget;
@@ -439,6 +565,50 @@ void UGuideMaskRegister::ConstructWidgetTree(OUT TArray<FGuideHierarchyNode>& Ou
 
 }
 
+bool UGuideMaskRegister::IsValidatedTagWidget(const FName& InTag, UWidget* InWidget, UWidgetTree* InWidgetTree) const
+{
+	const TWeakObjectPtr<UWidget>* Validated = ValidatedTagWidgets.Find(InTag);
+	if (nullptr == Validated || Validated->Get() != InWidget || nullptr == InWidgetTree)
+	{
+		return false;
+	}
+
+	// Removing a widget in the designer detaches it from its parent, which is enough to send it back to the full check.
+	return InWidget->GetTypedOuter<UWidgetTree>() == InWidgetTree &&
+		(InWidgetTree->RootWidget == InWidget || nullptr != InWidget->GetParent());
+}
+
+uint32 UGuideMaskRegister::GetPreviewHierarchyHash() const
+{
+	UWidget* TagWidget = TagWidgetList.FindRef(PreviewTag);
+
+	uint32 Hash = HashCombine(GetTypeHash(PreviewTag), GetTypeHash(TagWidget));
+	Hash = HashCombine(Hash, GetTypeHash(GetContainerEntryClass(TagWidget)));
+
+	for (const FGuideHierarchyNode& Node : WidgetHierarchy)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Node.Container));
+		Hash = HashCombine(Hash, GetTypeHash(GetContainerEntryClass(Node.Container)));
+	}
+
+	return Hash;
+}
+
+UClass* UGuideMaskRegister::GetContainerEntryClass(UWidget* InWidget)
+{
+	if (UListView* ListView = Cast<UListView>(InWidget))
+	{
+		return ListView->GetEntryWidgetClass();
+	}
+
+	else if (UDynamicEntryBox* EntryBox = Cast<UDynamicEntryBox>(InWidget))
+	{
+		return EntryBox->GetEntryWidgetClass();
+	}
+
+	return nullptr;
+}
+
 #endif
 
 
@@ -447,6 +617,36 @@ bool UGuideMaskRegister::IsContains(const FName& InTag) const
 	return TagWidgetList.Contains(InTag);
 }
 
+FGameplayTag UGuideMaskRegister::GetGameplayTag(const FName& InTag) const
+{
+	return GameplayTags.FindRef(InTag);
+}
+
+UWidget* UGuideMaskRegister::GetGameplayTagWidget(const FGameplayTag& InGameplayTag)
+{
+	const FName* Found = GameplayTagNames.Find(InGameplayTag);
+	return nullptr != Found ? GetTagWidget(*Found) : nullptr;
+}
+
+void UGuideMaskRegister::GetMatchingTagWidgets(const FGameplayTag& InParentTag, TArray<UWidget*>& OutWidgets)
+{
+	if (false == GameplayTagContainer.HasTag(InParentTag))
+	{
+		return;
+	}
+
+	for (const auto& Pair : GameplayTagNames)
+	{
+		if (true == Pair.Key.MatchesTag(InParentTag))
+		{
+			if (UWidget* Widget = GetTagWidget(Pair.Value))
+			{
+				OutWidgets.Emplace(Widget);
+			}
+		}
+	}
+}
+
 TArray<FName> UGuideMaskRegister::GetTagList() const
 {
 	TArray<FName> Retval;
@@ -521,6 +721,21 @@ void UGuideMaskRegister::SetLayer(UWidget* InLayer)
 	}
 }
 
+void UGuideMaskRegister::RebuildGameplayTagIndex()
+{
+	GameplayTagContainer.Reset();
+	GameplayTagNames.Reset();
+
+	for (const auto& Pair : GameplayTags)
+	{
+		if (Pair.Value.IsValid() && TagWidgetList.Contains(Pair.Key))
+		{
+			GameplayTagContainer.AddTag(Pair.Value);
+			GameplayTagNames.Emplace(Pair.Value, Pair.Key);
+		}
+	}
+}
+
 TSharedRef<SWidget> UGuideMaskRegister::RebuildWidget()
 {
 	Overlay = SNew(SOverlay);
@@ -536,6 +751,16 @@ TSharedRef<SWidget> UGuideMaskRegister::RebuildWidget()
 
 	SetVisibility(ESlateVisibility::SelfHitTestInvisible);
 
+	RebuildGameplayTagIndex();
+
+	if (false == IsDesignTime())
+	{
+		if (UGuideMaskRegistrySubsystem* Registry = UGuideMaskRegistrySubsystem::Get(this))
+		{
+			Registry->AddRegister(this);
+		}
+	}
+
 	return Overlay.ToSharedRef();
 }
 
@@ -557,6 +782,14 @@ void UGuideMaskRegister::ReleaseSlateResources(bool bReleaseChildren)
 		Overlay = nullptr;
 	}
 
+	if (false == IsDesignTime())
+	{
+		if (UGuideMaskRegistrySubsystem* Registry = UGuideMaskRegistrySubsystem::Get(this))
+		{
+			Registry->RemoveRegister(this);
+		}
+	}
+
 	Super::ReleaseSlateResources(bReleaseChildren);
 }
 
@@ -583,18 +816,28 @@ void UGuideMaskRegister::SynchronizeProperties()
 					continue;
 				}
 
+				// Only tags whose widget changed since the last sync pay for the tree search.
+				if (true == IsValidatedTagWidget(Tag, Widget, OuterWidget->WidgetTree))
+				{
+					continue;
+				}
+
 				if (OuterWidget->WidgetTree)
 				{
 					if (nullptr == OuterWidget->WidgetTree->FindWidget(Widget->GetFName()))
 					{
 						RemovedTag.Add(Tag);
+						continue;
 					}
 				}
+
+				ValidatedTagWidgets.Emplace(Tag, Widget);
 			}
 
 			for (int i = 0; i < RemovedTag.Num(); ++i)
 			{
 				TagWidgetList.Remove(RemovedTag[i]);
+				ValidatedTagWidgets.Remove(RemovedTag[i]);
 				bRemove = true;
 			}
 		}
@@ -608,7 +851,13 @@ void UGuideMaskRegister::SynchronizeProperties()
 #else
 			PreviewTag = 0 < TagList.Num() ? *TagList.begin() : FName();
 #endif
+		}
+
+		RefreshPreviewHierarchy();
 
+		// The target widget options come from the hierarchy of the new preview tag.
+		if (true == bRemove)
+		{
 			TArray<FName> WidgetList = GetNestedWidgetOptions();
 
 #if ENGINE_MAJOR_VERSION >= 5
@@ -616,13 +865,6 @@ void UGuideMaskRegister::SynchronizeProperties()
 #else
 			PreviewWidget = 0 < WidgetList.Num() ? *WidgetList.begin() : FName();
 #endif
-		} 
-
-		WidgetHierarchy.Reset();
-		if (TagWidgetList.Contains(PreviewTag))
-		{
-			UWidget* Widget = TagWidgetList.FindRef(PreviewTag);
-			ConstructWidgetTree(OUT WidgetHierarchy, Widget);
 		}
 	}
 
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ContentWidget.h"
+#include "GameplayTagContainer.h"
 
 #include "GuideMaskRegister.generated.h"
 
@@ -13,6 +14,8 @@
 
 
 class SOverlay;
+class UWidgetTree;
+class UGuideLayerBase;
 
 USTRUCT(BlueprintType)
 struct FGuideHierarchyNode
@@ -47,8 +50,32 @@ public:
 	bool GetGuideWidgetTree(OUT TArray<FGuideHierarchyNode>& OutWidgetTree, const FName& InGuideTag);
 	bool GetGuideWidgetList(OUT TArray<UWidget*>& OutWidgetList, const FName& InGuideTag);
 
+	const TMap<FName, UWidget*>& GetTagWidgetList() const { return TagWidgetList; }
+
+	/** Gameplay tag mapped to the tag, empty if it has none. */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "GuideMaskRegister")
+	FGameplayTag GetGameplayTag(const FName& InTag) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "GuideMaskRegister")
+	UWidget* GetGameplayTagWidget(const FGameplayTag& InGameplayTag);
+
+	/** Widgets of every mapped gameplay tag matching InParentTag, Guide.Shop matches Guide.Shop.Buy. */
+	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "GuideMaskRegister")
+	void GetMatchingTagWidgets(const FGameplayTag& InParentTag, TArray<UWidget*>& OutWidgets);
+
+	const FGameplayTagContainer& GetGameplayTagContainer() const { return GameplayTagContainer; }
+
+#if WITH_EDITOR
+	const TArray<FGuideHierarchyNode>& GetPreviewHierarchy() const { return WidgetHierarchy; }
+	static UClass* GetContainerEntryClass(UWidget* InWidget);
+
+	/** Broadcast after the designer rebuilt WidgetHierarchy for the preview tag. */
+	FSimpleMulticastDelegate OnPreviewHierarchyChanged;
+#endif
+
 private:
 	void SetLayer(UWidget* InLayer);
+	void RebuildGameplayTagIndex();
 
 protected:
 	virtual TSharedRef<SWidget> RebuildWidget() override;
@@ -70,6 +97,9 @@ protected:
 
 	void ConstructWidgetTree(OUT TArray<FGuideHierarchyNode>& OutNodeTree, UWidget* InWidget) const;
 
+	bool IsValidatedTagWidget(const FName& InTag, UWidget* InWidget, UWidgetTree* InWidgetTree) const;
+	uint32 GetPreviewHierarchyHash() const;
+
 	UFUNCTION()
 	TArray<FName> GetTagOptions() const;
 
@@ -77,7 +107,11 @@ protected:
 	TArray<FName> GetNestedWidgetOptions() const;
 
 
-	void CreatePreviewLayer(const FGeometry& InViewportGeometry);
+	void SetPreviewLayerClass(TSubclassOf<UGuideLayerBase> InLayerClass);
+	void RefreshPreviewLayer();
+	UWidget* ResolvePreviewTarget() const;
+	void RebuildPreviewNameIndex();
+	void RefreshPreviewHierarchy();
 #endif
 
 protected:
@@ -91,10 +125,34 @@ protected:
 	UPROPERTY(VisibleInstanceOnly, Category = "GuideMaskRegister")
 	TArray<FGuideHierarchyNode> WidgetHierarchy {};
 
+	// Designer sync caches. Tags already found in the widget tree, and the hierarchy they were built from.
+	TMap<FName, TWeakObjectPtr<UWidget>> ValidatedTagWidgets;
+	uint32 CachedHierarchyHash = 0;
+
+	// Preview targets of the current hierarchy by widget name.
+	TMap<FName, TWeakObjectPtr<UWidget>> PreviewNameIndex;
+
+	UPROPERTY(Transient)
+	TSubclassOf<UGuideLayerBase> PreviewLayerClass = nullptr;
+
+	UPROPERTY(Transient)
+	UGuideLayerBase* PreviewLayer = nullptr;
+
+	bool bShowPreview = false;
+	bool bPreviewLayerLoading = false;
 #endif
 	UPROPERTY(EditInstanceOnly, Category = "GuideMaskRegister")
 	TMap<FName, UWidget*> TagWidgetList;
 
+	// Optional gameplay tag of a tag in TagWidgetList, picked from the tag table instead of typed.
+	UPROPERTY(EditInstanceOnly, Category = "GuideMaskRegister", meta = (Categories = "Guide"))
+	TMap<FName, FGameplayTag> GameplayTags;
+
+private:
+	// Built from GameplayTags when the slate widget is built.
+	FGameplayTagContainer GameplayTagContainer;
+	TMap<FGameplayTag, FName> GameplayTagNames;
+
 private:
 	TSharedPtr<SOverlay> Overlay;
 	
@@ -72,40 +72,7 @@ void FGuideHierarchyNodeCustomization::CustomizeHeader(TSharedRef<IPropertyHandl
                             .Text(FText::FromString(TEXT("Open Entry Class BP")))
                             .OnClicked_Lambda([this]()
                                 {
-                                    if (UClass* EntryClass = GetEntryClass())
-                                    {
-                                        if (UBlueprint* Blueprint = Cast<UBlueprint>(EntryClass->ClassGeneratedBy))
-                                        {
-                                            if (UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
-                                            {
-                                                AssetEditorSubsystem->OpenEditorForAsset(Blueprint);
-                                                return FReply::Handled();
-                                            }
-
-                                            else
-                                            {
-                                                FNotificationInfo Info(FText::FromString(TEXT("ERROR")));
-                                                Info.Text = FText::FromString(TEXT("Invalid Asset Editor Subsystem!"));
-                                                Info.ExpireDuration = 3.0f;
-                                                Info.bUseLargeFont = false;
-
-                                                FSlateNotificationManager::Get().AddNotification(Info);
-
-                                                return FReply::Handled();
-                                            }
-
-                                        }
-
-                                    }
-
-                                    FNotificationInfo Info(FText::FromString(TEXT("ERROR")));
-                                    Info.Text = FText::FromString(TEXT("Do not found Widget Blueprint. Entry class is nullptr!"));
-                                    Info.ExpireDuration = 3.0f;
-                                    Info.bUseLargeFont = false;
-
-                                    FSlateNotificationManager::Get().AddNotification(Info);
-
-                                    return FReply::Handled();
+                                    return OpenEntryClassBlueprint(GetEntryClass());
                                 })
                     ]
 #if ENGINE_MAJOR_VERSION < 5
@@ -164,6 +131,59 @@ void FGuideHierarchyNodeCustomization::CustomizeChildren(TSharedRef<IPropertyHan
 
 }
 
+FReply FGuideHierarchyNodeCustomization::OpenEntryClassBlueprint(UClass* InEntryClass)
+{
+    if (nullptr != InEntryClass)
+    {
+        if (UBlueprint* Blueprint = Cast<UBlueprint>(InEntryClass->ClassGeneratedBy))
+        {
+            return OpenBlueprint(Blueprint);
+        }
+    }
+
+    FNotificationInfo Info(FText::FromString(TEXT("ERROR")));
+    Info.Text = FText::FromString(TEXT("Do not found Widget Blueprint. Entry class is nullptr!"));
+    Info.ExpireDuration = 3.0f;
+    Info.bUseLargeFont = false;
+
+    FSlateNotificationManager::Get().AddNotification(Info);
+
+    return FReply::Handled();
+}
+
+FReply FGuideHierarchyNodeCustomization::OpenBlueprint(UBlueprint* InBlueprint)
+{
+    if (nullptr != InBlueprint)
+    {
+        if (UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
+        {
+            AssetEditorSubsystem->OpenEditorForAsset(InBlueprint);
+            return FReply::Handled();
+        }
+
+        else
+        {
+            FNotificationInfo Info(FText::FromString(TEXT("ERROR")));
+            Info.Text = FText::FromString(TEXT("Invalid Asset Editor Subsystem!"));
+            Info.ExpireDuration = 3.0f;
+            Info.bUseLargeFont = false;
+
+            FSlateNotificationManager::Get().AddNotification(Info);
+
+            return FReply::Handled();
+        }
+    }
+
+    FNotificationInfo Info(FText::FromString(TEXT("ERROR")));
+    Info.Text = FText::FromString(TEXT("Do not found Widget Blueprint!"));
+    Info.ExpireDuration = 3.0f;
+    Info.bUseLargeFont = false;
+
+    FSlateNotificationManager::Get().AddNotification(Info);
+
+    return FReply::Handled();
+}
+
 UClass* FGuideHierarchyNodeCustomization::GetEntryClass() const
 {
     if (false == ContainerHandle.IsValid())
@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "IPropertyTypeCustomization.h"
+#include "Input/Reply.h"
+
+class UBlueprint;
 
 /**
  * 
@@ -19,6 +22,10 @@ public:
     virtual void CustomizeHeader(TSharedRef<IPropertyHandle> PropertyHandle, FDetailWidgetRow& HeaderRow, IPropertyTypeCustomizationUtils& CustomizationUtils) override;
     virtual void CustomizeChildren(TSharedRef<IPropertyHandle> PropertyHandle, IDetailChildrenBuilder& ChildBuilder, IPropertyTypeCustomizationUtils& CustomizationUtils) override;
 
+    // 엔트리 클래스 / 위젯 블루프린트 에디터 열기
+    static FReply OpenEntryClassBlueprint(UClass* InEntryClass);
+    static FReply OpenBlueprint(UBlueprint* InBlueprint);
+
 private:
     // ---- Header 요약용 ----
     FString GetContainerNameText() const;
@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideMaskAssetScan.h"
+
+#include "WidgetBlueprint.h"
+#include "Blueprint/WidgetTree.h"
+#include "Blueprint/IUserObjectListEntry.h"
+
+#include "Components/ListViewBase.h"
+#include "Components/DynamicEntryBox.h"
+
+#include "GuideMaskUI/UI/GuideMaskRegister.h"
+#include "GuideMaskUI/EntryGuideIdentifiable.h"
+
+
+namespace GuideMaskAssetScan
+{
+	UClass* GetEntryClass(UWidget* InWidget)
+	{
+		if (UListViewBase* ListView = Cast<UListViewBase>(InWidget))
+		{
+			return ListView->GetEntryWidgetClass();
+		}
+
+		else if (UDynamicEntryBox* EntryBox = Cast<UDynamicEntryBox>(InWidget))
+		{
+			return EntryBox->GetEntryWidgetClass();
+		}
+
+		return nullptr;
+	}
+
+	void AddIssue(TArray<FGuideValidationIssue>& OutIssues, FGuideValidationIssue::ESeverity InSeverity, const TCHAR* InCode, const FString& InMessage, const FName& InTag = NAME_None)
+	{
+		FGuideValidationIssue& Issue = OutIssues.AddDefaulted_GetRef();
+		Issue.Severity = InSeverity;
+		Issue.Code = InCode;
+		Issue.Message = InMessage;
+		Issue.Tag = InTag;
+	}
+}
+
+
+bool FGuideMaskAssetScan::CollectBlueprintRecord(const UWidgetBlueprint* InBlueprint, FGuideBlueprintRecord& OutRecord)
+{
+	if (nullptr == InBlueprint || nullptr == InBlueprint->WidgetTree)
+	{
+		return false;
+	}
+
+	OutRecord.AssetPath = InBlueprint->GetPathName();
+
+	if (UClass* GeneratedClass = InBlueprint->GeneratedClass)
+	{
+		OutRecord.bIsEntryClass =
+			GeneratedClass->ImplementsInterface(UEntryGuideIdentifiable::StaticClass()) ||
+			GeneratedClass->ImplementsInterface(UUserObjectListEntry::StaticClass());
+	}
+
+	TArray<UWidget*> Widgets;
+	InBlueprint->WidgetTree->GetAllWidgets(OUT Widgets);
+
+	for (UWidget* Widget : Widgets)
+	{
+		UGuideMaskRegister* Register = Cast<UGuideMaskRegister>(Widget);
+		if (nullptr == Register)
+		{
+			continue;
+		}
+
+		++OutRecord.RegisterCount;
+
+		if (Register != InBlueprint->WidgetTree->RootWidget)
+		{
+			OutRecord.bRegisterNotRoot = true;
+		}
+
+		for (const TPair<FName, UWidget*>& Pair : Register->GetTagWidgetList())
+		{
+			FGuideTagRecord& TagRecord = OutRecord.Tags.AddDefaulted_GetRef();
+			TagRecord.Tag = Pair.Key;
+
+			UWidget* TagWidget = Pair.Value;
+			if (nullptr == TagWidget)
+			{
+				TagRecord.bWidgetMissing = true;
+				continue;
+			}
+
+			TagRecord.WidgetName = TagWidget->GetName();
+			TagRecord.WidgetClass = TagWidget->GetClass()->GetName();
+			TagRecord.bWidgetNotInTree = TagWidget != InBlueprint->WidgetTree->FindWidget(TagWidget->GetFName());
+
+			if (UClass* EntryClass = GuideMaskAssetScan::GetEntryClass(TagWidget))
+			{
+				TagRecord.EntryClass = EntryClass->GetPathName();
+
+				TSet<const UClass*> Visited;
+				int32 MaxDepth = 0;
+				CollectEntryClasses(EntryClass, TagRecord.WidgetName, 1, Visited, OutRecord.EntryClasses, MaxDepth);
+
+				TagRecord.ContainerDepth = MaxDepth;
+			}
+
+			else if (UUserWidget* UserWidget = Cast<UUserWidget>(TagWidget))
+			{
+				if (UWidgetBlueprint* TaggedBlueprint = Cast<UWidgetBlueprint>(UserWidget->GetClass()->ClassGeneratedBy))
+				{
+					TagRecord.bTaggedRegister = TaggedBlueprint->WidgetTree && TaggedBlueprint->WidgetTree->RootWidget &&
+						TaggedBlueprint->WidgetTree->RootWidget->IsA(UGuideMaskRegister::StaticClass());
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void FGuideMaskAssetScan::CollectEntryClasses(UClass* InEntryClass, const FString& InContainerName, int32 InDepth, TSet<const UClass*>& InOutVisited, TArray<FGuideEntryClassRecord>& OutEntryClasses, int32& OutMaxDepth)
+{
+	if (nullptr == InEntryClass)
+	{
+		return;
+	}
+
+	OutMaxDepth = FMath::Max(OutMaxDepth, InDepth);
+
+	const FString EntryClassPath = InEntryClass->GetPathName();
+	const bool bAlreadyRecorded = OutEntryClasses.ContainsByPredicate([&](const FGuideEntryClassRecord& InRecord)
+		{
+			return InRecord.EntryClass == EntryClassPath && InRecord.ContainerName == InContainerName;
+		});
+
+	if (false == bAlreadyRecorded)
+	{
+		FGuideEntryClassRecord& Record = OutEntryClasses.AddDefaulted_GetRef();
+		Record.EntryClass = EntryClassPath;
+		Record.ContainerName = InContainerName;
+		Record.Depth = InDepth;
+		Record.bImplementsIdentifiable = InEntryClass->ImplementsInterface(UEntryGuideIdentifiable::StaticClass());
+	}
+
+	if (true == InOutVisited.Contains(InEntryClass))
+	{
+		return;
+	}
+
+	InOutVisited.Add(InEntryClass);
+
+	// Nested containers are only reachable through the entry blueprint, native entries stop here.
+	UWidgetBlueprint* EntryBlueprint = Cast<UWidgetBlueprint>(InEntryClass->ClassGeneratedBy);
+	if (nullptr == EntryBlueprint || nullptr == EntryBlueprint->WidgetTree)
+	{
+		return;
+	}
+
+	TArray<UWidget*> Widgets;
+	EntryBlueprint->WidgetTree->GetAllWidgets(OUT Widgets);
+
+	for (UWidget* Widget : Widgets)
+	{
+		if (UClass* NestedEntryClass = GuideMaskAssetScan::GetEntryClass(Widget))
+		{
+			CollectEntryClasses(NestedEntryClass, Widget->GetName(), InDepth + 1, InOutVisited, OutEntryClasses, OutMaxDepth);
+		}
+	}
+}
+
+void FGuideMaskAssetScan::ValidateRecord(const FGuideBlueprintRecord& InRecord, TArray<FGuideValidationIssue>& OutIssues)
+{
+	using ESeverity = FGuideValidationIssue::ESeverity;
+
+	if (InRecord.RegisterCount > 1)
+	{
+		GuideMaskAssetScan::AddIssue(OutIssues, ESeverity::Error, TEXT("MultipleRegisters"),
+			FString::Printf(TEXT("%d registers found. Please only one register at the top of the hierarchy!"), InRecord.RegisterCount));
+	}
+
+	if (true == InRecord.bRegisterNotRoot)
+	{
+		GuideMaskAssetScan::AddIssue(OutIssues, ESeverity::Error, TEXT("RegisterNotRoot"),
+			TEXT("Register is not the root widget of the hierarchy."));
+	}
+
+	if (true == InRecord.bIsEntryClass && InRecord.RegisterCount > 0)
+	{
+		GuideMaskAssetScan::AddIssue(OutIssues, ESeverity::Error, TEXT("RegisterInEntry"),
+			TEXT("Do not use Guide Register in list entry widget or inherited EntryGuideIdentifiable widget!"));
+	}
+
+	for (const FGuideTagRecord& Tag : InRecord.Tags)
+	{
+		if (Tag.Tag.IsNone())
+		{
+			GuideMaskAssetScan::AddIssue(OutIssues, ESeverity::Error, TEXT("EmptyTag"),
+				FString::Printf(TEXT("Widget %s is registered with an empty tag."), *Tag.WidgetName), Tag.Tag);
+		}
+
+		if (true == Tag.bWidgetMissing)
+		{
+			GuideMaskAssetScan::AddIssue(OutIssues, ESeverity::Error, TEXT("StaleTag"),
+				FString::Printf(TEXT("Tag %s has no widget."), *Tag.Tag.ToString()), Tag.Tag);
+		}
+
+		else if (true == Tag.bWidgetNotInTree)
+		{
+			GuideMaskAssetScan::AddIssue(OutIssues, ESeverity::Error, TEXT("StaleTag"),
+				FString::Printf(TEXT("Tag %s points to %s, which is no longer in the widget tree."), *Tag.Tag.ToString(), *Tag.WidgetName), Tag.Tag);
+		}
+
+		if (true == Tag.bTaggedRegister)
+		{
+			GuideMaskAssetScan::AddIssue(OutIssues, ESeverity::Error, TEXT("NestedRegister"),
+				FString::Printf(TEXT("Do not containing GuideRegister in TagWidgetList. Widget Name : %s"), *Tag.WidgetName), Tag.Tag);
+		}
+	}
+
+	for (const FGuideEntryClassRecord& Entry : InRecord.EntryClasses)
+	{
+		if (true == Entry.bImplementsIdentifiable)
+		{
+			continue;
+		}
+
+		// Tagged containers can't resolve children without the interface, deeper ones only lose their nested widgets.
+		GuideMaskAssetScan::AddIssue(OutIssues, 1 == Entry.Depth ? ESeverity::Error : ESeverity::Warning, TEXT("MissingIdentifiable"),
+			FString::Printf(TEXT("%s Class doesn't implement EntryGuideIdentifiable Interface! (Container : %s, Depth : %d)"),
+				*Entry.EntryClass, *Entry.ContainerName, Entry.Depth));
+	}
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWidgetBlueprint;
+class UClass;
+
+/**
+ * Plain (non-UObject) snapshot of one guide tag, safe to hand to worker threads.
+ */
+struct FGuideTagRecord
+{
+	FName Tag;
+	FString WidgetName;
+	FString WidgetClass;
+
+	// Entry class of the tagged container, empty for plain widgets.
+	FString EntryClass;
+
+	// Depth of entry based containers nested below the tagged widget. 0 = no container.
+	int32 ContainerDepth = 0;
+
+	bool bWidgetMissing = false;
+	bool bWidgetNotInTree = false;
+	bool bTaggedRegister = false;
+};
+
+struct FGuideEntryClassRecord
+{
+	FString EntryClass;
+	FString ContainerName;
+	int32 Depth = 0;
+	bool bImplementsIdentifiable = false;
+};
+
+/**
+ * Plain snapshot of one widget blueprint. Collected on the game thread, validated anywhere.
+ */
+struct FGuideBlueprintRecord
+{
+	FString AssetPath;
+
+	TArray<FGuideTagRecord> Tags;
+	TArray<FGuideEntryClassRecord> EntryClasses;
+
+	int32 RegisterCount = 0;
+	bool bRegisterNotRoot = false;
+	bool bIsEntryClass = false;
+};
+
+struct FGuideValidationIssue
+{
+	enum class ESeverity : uint8
+	{
+		Warning,
+		Error,
+	};
+
+	ESeverity Severity = ESeverity::Error;
+	FString Code;
+	FString Message;
+	FName Tag;
+};
+
+struct FGuideMaskAssetScan
+{
+	/** Reads every register in the blueprint. Must run on the game thread. */
+	static bool CollectBlueprintRecord(const UWidgetBlueprint* InBlueprint, FGuideBlueprintRecord& OutRecord);
+
+	/** Per-blueprint checks. Touches no UObject, so it can run on any thread. */
+	static void ValidateRecord(const FGuideBlueprintRecord& InRecord, TArray<FGuideValidationIssue>& OutIssues);
+
+private:
+	static void CollectEntryClasses(UClass* InEntryClass, const FString& InContainerName, int32 InDepth, TSet<const UClass*>& InOutVisited, TArray<FGuideEntryClassRecord>& OutEntryClasses, int32& OutMaxDepth);
+};
@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideMaskAssetTags.h"
+#include "GuideMaskAssetScan.h"
+
+#include "WidgetBlueprint.h"
+#include "K2Node_CallFunction.h"
+#include "EdGraphSchema_K2.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+
+#include "GuideMaskUI/GuideMaskUIFunctionLibrary.h"
+#include "GuideMaskUI/UI/GuideMaskRegister.h"
+
+
+const FName FGuideMaskAssetTags::TagListName = FName(TEXT("GuideMaskTags"));
+const FName FGuideMaskAssetTags::TagReferencesName = FName(TEXT("GuideMaskTagRefs"));
+
+namespace GuideMaskAssetTags
+{
+	const TCHAR* RecordDelimiter = TEXT(";");
+	const TCHAR* FieldDelimiter = TEXT("|");
+
+	bool IsGuideFunction(const UFunction* InFunction)
+	{
+		if (nullptr == InFunction)
+		{
+			return false;
+		}
+
+		const UClass* OwnerClass = InFunction->GetOwnerClass();
+		return nullptr != OwnerClass &&
+			(OwnerClass->IsChildOf(UGuideMaskUIFunctionLibrary::StaticClass()) || OwnerClass->IsChildOf(UGuideMaskRegister::StaticClass()));
+	}
+}
+
+
+void FGuideMaskAssetTags::GetAssetRegistryTags(const UObject* InObject, TArray<UObject::FAssetRegistryTag>& OutTags)
+{
+	const UBlueprint* Blueprint = Cast<UBlueprint>(InObject);
+	if (nullptr == Blueprint)
+	{
+		return;
+	}
+
+	if (const UWidgetBlueprint* WidgetBlueprint = Cast<UWidgetBlueprint>(Blueprint))
+	{
+		FGuideBlueprintRecord Record;
+		if (true == FGuideMaskAssetScan::CollectBlueprintRecord(WidgetBlueprint, Record) && 0 < Record.Tags.Num())
+		{
+			OutTags.Emplace(TagListName, ExportTagRecords(Record.Tags), UObject::FAssetRegistryTag::TT_Hidden);
+		}
+	}
+
+	TArray<FName> References;
+	CollectTagReferences(Blueprint, References);
+
+	if (0 < References.Num())
+	{
+		OutTags.Emplace(TagReferencesName, ExportTagReferences(References), UObject::FAssetRegistryTag::TT_Hidden);
+	}
+}
+
+FString FGuideMaskAssetTags::ExportTagRecords(const TArray<FGuideTagRecord>& InRecords)
+{
+	TArray<FString> Records;
+	Records.Reserve(InRecords.Num());
+
+	for (const FGuideTagRecord& Record : InRecords)
+	{
+		if (Record.Tag.IsNone())
+		{
+			continue;
+		}
+
+		Records.Emplace(FString::Join(TArray<FString>
+			{
+				Record.Tag.ToString(),
+				Record.WidgetName,
+				Record.WidgetClass,
+				FString::FromInt(Record.ContainerDepth)
+			}, GuideMaskAssetTags::FieldDelimiter));
+	}
+
+	return FString::Join(Records, GuideMaskAssetTags::RecordDelimiter);
+}
+
+void FGuideMaskAssetTags::ImportTagRecords(const FString& InValue, TArray<FGuideTagRecord>& OutRecords)
+{
+	TArray<FString> Records;
+	InValue.ParseIntoArray(Records, GuideMaskAssetTags::RecordDelimiter, true);
+
+	for (const FString& Record : Records)
+	{
+		TArray<FString> Fields;
+		Record.ParseIntoArray(Fields, GuideMaskAssetTags::FieldDelimiter, false);
+
+		if (Fields.Num() < 4 || Fields[0].IsEmpty())
+		{
+			continue;
+		}
+
+		FGuideTagRecord& TagRecord = OutRecords.AddDefaulted_GetRef();
+		TagRecord.Tag = FName(*Fields[0]);
+		TagRecord.WidgetName = Fields[1];
+		TagRecord.WidgetClass = Fields[2];
+		TagRecord.ContainerDepth = FCString::Atoi(*Fields[3]);
+		TagRecord.bWidgetMissing = Fields[1].IsEmpty();
+	}
+}
+
+FString FGuideMaskAssetTags::ExportTagReferences(const TArray<FName>& InTags)
+{
+	TArray<FString> Tags;
+	Tags.Reserve(InTags.Num());
+
+	for (const FName& Tag : InTags)
+	{
+		Tags.Emplace(Tag.ToString());
+	}
+
+	return FString::Join(Tags, GuideMaskAssetTags::RecordDelimiter);
+}
+
+void FGuideMaskAssetTags::ImportTagReferences(const FString& InValue, TArray<FName>& OutTags)
+{
+	TArray<FString> Tags;
+	InValue.ParseIntoArray(Tags, GuideMaskAssetTags::RecordDelimiter, true);
+
+	for (const FString& Tag : Tags)
+	{
+		OutTags.AddUnique(FName(*Tag));
+	}
+}
+
+void FGuideMaskAssetTags::CollectTagReferences(const UBlueprint* InBlueprint, TArray<FName>& OutTags)
+{
+	TArray<UK2Node_CallFunction*> CallNodes;
+	FBlueprintEditorUtils::GetAllNodesOfClass<UK2Node_CallFunction>(InBlueprint, CallNodes);
+
+	for (UK2Node_CallFunction* CallNode : CallNodes)
+	{
+		if (false == GuideMaskAssetTags::IsGuideFunction(CallNode->GetTargetFunction()))
+		{
+			continue;
+		}
+
+		// Only literal tags are known at edit time, connected pins are resolved at runtime.
+		for (UEdGraphPin* Pin : CallNode->Pins)
+		{
+			if (nullptr == Pin || EGPD_Input != Pin->Direction || UEdGraphSchema_K2::PC_Name != Pin->PinType.PinCategory || 0 < Pin->LinkedTo.Num())
+			{
+				continue;
+			}
+
+			const FName Tag = FName(*Pin->GetDefaultAsString());
+			if (false == Tag.IsNone())
+			{
+				OutTags.AddUnique(Tag);
+			}
+		}
+	}
+}
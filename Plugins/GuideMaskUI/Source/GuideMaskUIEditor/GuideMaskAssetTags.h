@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+
+struct FGuideTagRecord;
+class UBlueprint;
+
+/**
+ * Guide data written into the asset registry, so tools can list tags without loading blueprints.
+ * Values are written when an asset is saved, older assets show up after a resave.
+ */
+struct FGuideMaskAssetTags
+{
+	// Registered tags of a widget blueprint. "Tag|Widget|WidgetClass|Depth;..."
+	static const FName TagListName;
+
+	// Tags passed as literals to guide functions in any blueprint graph. "TagA;TagB"
+	static const FName TagReferencesName;
+
+	static void GetAssetRegistryTags(const UObject* InObject, TArray<UObject::FAssetRegistryTag>& OutTags);
+
+	static FString ExportTagRecords(const TArray<FGuideTagRecord>& InRecords);
+	static void ImportTagRecords(const FString& InValue, TArray<FGuideTagRecord>& OutRecords);
+
+	static FString ExportTagReferences(const TArray<FName>& InTags);
+	static void ImportTagReferences(const FString& InValue, TArray<FName>& OutTags);
+
+private:
+	static void CollectTagReferences(const UBlueprint* InBlueprint, TArray<FName>& OutTags);
+};
@@ -0,0 +1,512 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideMaskLayoutCommandlet.h"
+#include "GuideMaskValidateCommandlet.h"
+#include "GuideMaskAssetScan.h"
+
+#include "WidgetBlueprint.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Engine/UserInterfaceSettings.h"
+#include "Engine/World.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Interfaces/ISlateNullRendererModule.h"
+#include "Layout/ArrangedChildren.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+
+#include "GuideMaskUI/UI/GuideMaskRegister.h"
+#include "GuideMaskUI/UI/GuideLayerBase.h"
+#include "GuideMaskUI/GuideMaskSettings.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION >= 5
+#include "AssetRegistry/AssetData.h"
+#else
+#include "AssetData.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogGuideMaskLayout, Log, All);
+
+
+struct FGuideLayoutRect
+{
+	FName Tag;
+
+	// Guide box in viewport widget space, the cutout is centered on it.
+	FVector2D Position = FVector2D::ZeroVector;
+	FVector2D Size = FVector2D::ZeroVector;
+};
+
+/**
+ * One widget blueprint laid out at one resolution.
+ */
+struct FGuideLayoutResult
+{
+	FString AssetPath;
+	FIntPoint Resolution = FIntPoint::ZeroValue;
+	float DPIScale = 1.f;
+
+	TArray<FGuideLayoutRect> Rects;
+	TArray<FGuideValidationIssue> Issues;
+};
+
+namespace GuideMaskLayout
+{
+	// Every screen keeps its slate tree alive until it was laid out at every resolution, release them in batches.
+	constexpr int32 GarbageCollectInterval = 50;
+
+	// Desktop, ultrawide, phone, 4:3 and tablet screens.
+	const TCHAR* const DefaultResolutions = TEXT("1920x1080,1280x720,2560x1440,3440x1440,2400x1080,1024x768,2732x2048");
+
+	// Title safe ratio most platform guidelines ask for.
+	constexpr float DefaultSafeZoneRatio = 0.9f;
+
+	// Half a slate unit, rounding of the layout must not count as clipping.
+	constexpr float EdgeTolerance = 0.5f;
+
+	struct FResolution
+	{
+		FIntPoint Size = FIntPoint::ZeroValue;
+		float DPIScale = 1.f;
+	};
+
+	bool ParseResolutions(const FString& InValue, TArray<FResolution>& OutResolutions)
+	{
+		TArray<FString> Entries;
+		InValue.ParseIntoArray(Entries, TEXT(","));
+
+		for (const FString& Entry : Entries)
+		{
+			const FString Trimmed = Entry.TrimStartAndEnd();
+
+			FString SizeText = Trimmed;
+			FString ScaleText;
+			Trimmed.Split(TEXT("@"), &SizeText, &ScaleText);
+
+			FString WidthText;
+			FString HeightText;
+
+			FResolution Resolution;
+			if (true == SizeText.Split(TEXT("x"), &WidthText, &HeightText))
+			{
+				Resolution.Size = FIntPoint(FCString::Atoi(*WidthText), FCString::Atoi(*HeightText));
+			}
+
+			if (Resolution.Size.X <= 0 || Resolution.Size.Y <= 0)
+			{
+				UE_LOG(LogGuideMaskLayout, Error, TEXT("Invalid resolution : %s"), *Trimmed);
+				return false;
+			}
+
+			// Without an explicit scale, the one the project's DPI curve gives this screen.
+			Resolution.DPIScale = ScaleText.IsEmpty() ?
+				GetDefault<UUserInterfaceSettings>()->GetDPIScaleBasedOnSize(Resolution.Size) : FCString::Atof(*ScaleText);
+
+			if (Resolution.DPIScale <= 0.f)
+			{
+				UE_LOG(LogGuideMaskLayout, Error, TEXT("Invalid DPI scale : %s"), *Trimmed);
+				return false;
+			}
+
+			OutResolutions.Emplace(Resolution);
+		}
+
+		return 0 < OutResolutions.Num();
+	}
+
+	// Text can't be measured without a slate application. Headless runs get one with the null renderer, nothing is drawn.
+	bool EnsureSlateApplication()
+	{
+		if (true == FSlateApplication::IsInitialized())
+		{
+			return true;
+		}
+
+		FSlateApplication::Create();
+
+		TSharedRef<FSlateRenderer> Renderer = FModuleManager::LoadModuleChecked<ISlateNullRendererModule>("SlateNullRenderer").CreateSlateNullRenderer();
+		return FSlateApplication::Get().InitializeRenderer(Renderer);
+	}
+
+	void CollectRegisters(UUserWidget* InWidget, TArray<UGuideMaskRegister*>& OutRegisters)
+	{
+		if (nullptr == InWidget || nullptr == InWidget->WidgetTree)
+		{
+			return;
+		}
+
+		InWidget->WidgetTree->ForEachWidget([&OutRegisters](UWidget* InChild)
+			{
+				if (UGuideMaskRegister* Register = Cast<UGuideMaskRegister>(InChild))
+				{
+					OutRegisters.Emplace(Register);
+				}
+
+				else if (UUserWidget* UserWidget = Cast<UUserWidget>(InChild))
+				{
+					CollectRegisters(UserWidget, OutRegisters);
+				}
+			});
+	}
+
+	// Same arrangement a paint pass would do, without painting. Collapsed and hidden widgets are left out.
+	void ArrangeRecursive(const TSharedRef<SWidget>& InWidget, const FGeometry& InGeometry, TMap<const SWidget*, FGeometry>& OutGeometries)
+	{
+		OutGeometries.Emplace(&InWidget.Get(), InGeometry);
+
+		FArrangedChildren ArrangedChildren(EVisibility::Visible);
+		InWidget->ArrangeChildren(InGeometry, ArrangedChildren);
+
+		for (int32 i = 0; i < ArrangedChildren.Num(); ++i)
+		{
+			ArrangeRecursive(ArrangedChildren[i].Widget, ArrangedChildren[i].Geometry, OutGeometries);
+		}
+	}
+
+	void AddIssue(FGuideLayoutResult& InOutResult, FGuideValidationIssue::ESeverity InSeverity, const TCHAR* InCode, const FString& InMessage, const FName& InTag)
+	{
+		FGuideValidationIssue& Issue = InOutResult.Issues.AddDefaulted_GetRef();
+		Issue.Severity = InSeverity;
+		Issue.Code = InCode;
+		Issue.Message = InMessage;
+		Issue.Tag = InTag;
+	}
+
+	bool Contains(const FBox2D& InOuter, const FBox2D& InInner)
+	{
+		return InInner.Min.X >= InOuter.Min.X - EdgeTolerance && InInner.Min.Y >= InOuter.Min.Y - EdgeTolerance &&
+			InInner.Max.X <= InOuter.Max.X + EdgeTolerance && InInner.Max.Y <= InOuter.Max.Y + EdgeTolerance;
+	}
+
+	bool Overlaps(const FBox2D& InA, const FBox2D& InB)
+	{
+		return FMath::Min(InA.Max.X, InB.Max.X) - FMath::Max(InA.Min.X, InB.Min.X) > EdgeTolerance &&
+			FMath::Min(InA.Max.Y, InB.Max.Y) - FMath::Max(InA.Min.Y, InB.Min.Y) > EdgeTolerance;
+	}
+
+	void CheckRects(FGuideLayoutResult& InOutResult, const FVector2D& InScreenSize, const FVector2D& InSafePosition, const FVector2D& InSafeSize)
+	{
+		const FBox2D Screen(FVector2D::ZeroVector, InScreenSize);
+		const FBox2D SafeZone(InSafePosition, InSafePosition + InSafeSize);
+
+		TArray<FBox2D> Boxes;
+		Boxes.Reserve(InOutResult.Rects.Num());
+
+		for (const FGuideLayoutRect& Rect : InOutResult.Rects)
+		{
+			const FBox2D& Box = Boxes.Emplace_GetRef(Rect.Position, Rect.Position + Rect.Size);
+
+			if (Rect.Size.X <= 0.f || Rect.Size.Y <= 0.f)
+			{
+				AddIssue(InOutResult, FGuideValidationIssue::ESeverity::Warning, TEXT("ZeroSize"),
+					FString::Printf(TEXT("Tag %s has no area, its cutout is invisible."), *Rect.Tag.ToString()), Rect.Tag);
+			}
+
+			else if (false == Overlaps(Screen, Box))
+			{
+				AddIssue(InOutResult, FGuideValidationIssue::ESeverity::Error, TEXT("OffScreen"),
+					FString::Printf(TEXT("Tag %s at (%.0f, %.0f) is entirely off screen."), *Rect.Tag.ToString(), Rect.Position.X, Rect.Position.Y), Rect.Tag);
+			}
+
+			else if (false == Contains(Screen, Box))
+			{
+				AddIssue(InOutResult, FGuideValidationIssue::ESeverity::Error, TEXT("PartiallyOffScreen"),
+					FString::Printf(TEXT("Tag %s at (%.0f, %.0f) size (%.0f, %.0f) is cut by the screen edge."),
+						*Rect.Tag.ToString(), Rect.Position.X, Rect.Position.Y, Rect.Size.X, Rect.Size.Y), Rect.Tag);
+			}
+
+			else if (false == Contains(SafeZone, Box))
+			{
+				AddIssue(InOutResult, FGuideValidationIssue::ESeverity::Warning, TEXT("SafeZone"),
+					FString::Printf(TEXT("Tag %s at (%.0f, %.0f) size (%.0f, %.0f) reaches outside the safe zone."),
+						*Rect.Tag.ToString(), Rect.Position.X, Rect.Position.Y, Rect.Size.X, Rect.Size.Y), Rect.Tag);
+			}
+		}
+
+		// A target nested in another is fine (a tagged panel and its button), a partial overlap makes one cutout cover the other.
+		for (int32 i = 0; i < Boxes.Num(); ++i)
+		{
+			for (int32 j = i + 1; j < Boxes.Num(); ++j)
+			{
+				if (true == Overlaps(Boxes[i], Boxes[j]) && false == Contains(Boxes[i], Boxes[j]) && false == Contains(Boxes[j], Boxes[i]))
+				{
+					AddIssue(InOutResult, FGuideValidationIssue::ESeverity::Warning, TEXT("Overlap"),
+						FString::Printf(TEXT("Tags %s and %s overlap."), *InOutResult.Rects[i].Tag.ToString(), *InOutResult.Rects[j].Tag.ToString()),
+						InOutResult.Rects[i].Tag);
+				}
+			}
+		}
+	}
+
+	void LayoutWidget(UWorld* InWorld, UClass* InWidgetClass, const FString& InAssetPath, const TArray<FResolution>& InResolutions,
+		float InSafeZoneRatio, const FMargin& InBoxOffset, TArray<FGuideLayoutResult>& OutResults)
+	{
+		UUserWidget* Widget = CreateWidget<UUserWidget>(InWorld, InWidgetClass);
+		if (nullptr == Widget)
+		{
+			return;
+		}
+
+		// Laid out as in the designer, construct events and game code of the screen don't run without a player.
+		Widget->SetDesignerFlags(EWidgetDesignFlags::Designing);
+
+		TSharedRef<SWidget> RootWidget = Widget->TakeWidget();
+
+		TArray<UGuideMaskRegister*> Registers;
+		CollectRegisters(Widget, Registers);
+
+		for (const FResolution& Resolution : InResolutions)
+		{
+			// Viewport widget space, the space of the layer's rect math: screen pixels over the DPI scale.
+			const FVector2D ScreenSize = FVector2D(Resolution.Size) / Resolution.DPIScale;
+			const FGeometry ViewportGeometry = FGeometry::MakeRoot(ScreenSize, FSlateLayoutTransform(Resolution.DPIScale));
+
+			// The debug safe zone of the title ratio in pixels, then the same rect the layer builds from the platform's safe zone.
+			const FVector2D SafePadding = FVector2D(Resolution.Size) * (1.f - InSafeZoneRatio) * 0.5f;
+
+			FVector2D SafePosition;
+			FVector2D SafeSize;
+			UGuideLayerBase::GetViewportSafeRect(FMargin(SafePadding.X, SafePadding.Y), ScreenSize, Resolution.DPIScale, SafePosition, SafeSize);
+
+			RootWidget->SlatePrepass(Resolution.DPIScale);
+
+			TMap<const SWidget*, FGeometry> Geometries;
+			ArrangeRecursive(RootWidget, ViewportGeometry, Geometries);
+
+			FGuideLayoutResult& Result = OutResults.AddDefaulted_GetRef();
+			Result.AssetPath = InAssetPath;
+			Result.Resolution = Resolution.Size;
+			Result.DPIScale = Resolution.DPIScale;
+
+			for (const UGuideMaskRegister* Register : Registers)
+			{
+				for (const TPair<FName, UWidget*>& Pair : Register->GetTagWidgetList())
+				{
+					const TSharedPtr<SWidget> TagSlateWidget = nullptr != Pair.Value ? Pair.Value->GetCachedWidget() : nullptr;
+					const FGeometry* WidgetGeometry = TagSlateWidget.IsValid() ? Geometries.Find(TagSlateWidget.Get()) : nullptr;
+
+					if (nullptr == WidgetGeometry)
+					{
+						AddIssue(Result, FGuideValidationIssue::ESeverity::Warning, TEXT("NotLaidOut"),
+							FString::Printf(TEXT("Tag %s is collapsed, hidden or needs list items, it was not checked."), *Pair.Key.ToString()), Pair.Key);
+						continue;
+					}
+
+					FVector2D TargetPosition;
+					FVector2D TargetSize;
+					UGuideLayerBase::GetGeometryViewportRect(ViewportGeometry, *WidgetGeometry, TargetPosition, TargetSize);
+
+					FGuideLayoutRect& Rect = Result.Rects.AddDefaulted_GetRef();
+					Rect.Tag = Pair.Key;
+					UGuideLayerBase::GetGuideBoxRect(InBoxOffset, TargetPosition, TargetSize, Rect.Position, Rect.Size);
+					UGuideLayerBase::ClampGuideBoxRect(SafePosition, SafeSize, TargetPosition, TargetSize, Rect.Position, Rect.Size);
+				}
+			}
+
+			CheckRects(Result, ScreenSize, SafePosition, SafeSize);
+		}
+
+		// The slate tree holds the widget, it is only collectable once released.
+		Widget->ReleaseSlateResources(true);
+	}
+}
+
+
+UGuideMaskLayoutCommandlet::UGuideMaskLayoutCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Lays out guide screens at several resolutions and reports off-screen, safe zone clipped and overlapping guide rects.");
+	HelpUsage = TEXT("-run=GuideMaskLayout [-Path=/Game] [-Report=<File.json>] [-All] [-Resolutions=1920x1080,2732x2048@2.0] [-SafeZone=<TitleRatio>]");
+}
+
+int32 UGuideMaskLayoutCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamMap);
+
+	const FString SearchPath = ParamMap.Contains(TEXT("Path")) ? ParamMap[TEXT("Path")] : TEXT("/Game");
+	const FString ReportPath = ParamMap.Contains(TEXT("Report")) ? ParamMap[TEXT("Report")] : FPaths::ProjectSavedDir() / TEXT("GuideMask") / TEXT("GuideMaskLayout.json");
+	const bool bScanAll = Switches.Contains(TEXT("All"));
+
+	TArray<GuideMaskLayout::FResolution> Resolutions;
+	if (false == GuideMaskLayout::ParseResolutions(ParamMap.Contains(TEXT("Resolutions")) ? ParamMap[TEXT("Resolutions")] : GuideMaskLayout::DefaultResolutions, Resolutions))
+	{
+		return 1;
+	}
+
+	// The cvar defaults to 1 (no safe zone), it only counts when an ini or the command line set it.
+	float SafeZoneRatio = GuideMaskLayout::DefaultSafeZoneRatio;
+	IConsoleVariable* TitleRatio = IConsoleManager::Get().FindConsoleVariable(TEXT("r.DebugSafeZone.TitleRatio"));
+	if (nullptr != TitleRatio && (TitleRatio->GetFlags() & ECVF_SetByMask) > ECVF_SetByConstructor)
+	{
+		SafeZoneRatio = TitleRatio->GetFloat();
+	}
+
+	if (ParamMap.Contains(TEXT("SafeZone")))
+	{
+		SafeZoneRatio = FCString::Atof(*ParamMap[TEXT("SafeZone")]);
+	}
+
+	SafeZoneRatio = FMath::Clamp(SafeZoneRatio, 0.1f, 1.f);
+
+	if (false == GuideMaskLayout::EnsureSlateApplication())
+	{
+		UE_LOG(LogGuideMaskLayout, Error, TEXT("No slate application, widgets can't be laid out."));
+		return 1;
+	}
+
+	// Guides grow the cutout by the box offset of the layer they are shown with.
+	FMargin BoxOffset;
+	if (const UGuideMaskSettings* Settings = GetDefault<UGuideMaskSettings>())
+	{
+		if (UClass* LayerClass = Settings->DefaultLayer.LoadSynchronous())
+		{
+			BoxOffset = GetDefault<UGuideLayerBase>(LayerClass)->GetBoxOffset();
+		}
+	}
+
+	TArray<FAssetData> Assets;
+	UGuideMaskValidateCommandlet::GatherWidgetBlueprints(SearchPath, bScanAll, Assets);
+
+	UE_LOG(LogGuideMaskLayout, Display, TEXT("Laying out %d widget blueprints under %s at %d resolutions"), Assets.Num(), *SearchPath, Resolutions.Num());
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::EditorPreview, false, TEXT("GuideMaskLayout"));
+
+	TArray<FGuideLayoutResult> Results;
+
+	for (int32 i = 0; i < Assets.Num(); ++i)
+	{
+		const UWidgetBlueprint* Blueprint = Cast<UWidgetBlueprint>(Assets[i].GetAsset());
+
+		// Screens without a register have nothing to check, skip building them.
+		FGuideBlueprintRecord Record;
+		if (true == FGuideMaskAssetScan::CollectBlueprintRecord(Blueprint, Record) && Record.RegisterCount > 0)
+		{
+			UClass* WidgetClass = Blueprint->GeneratedClass;
+			if (nullptr != WidgetClass && false == WidgetClass->HasAnyClassFlags(CLASS_Abstract) && true == WidgetClass->IsChildOf(UUserWidget::StaticClass()))
+			{
+				GuideMaskLayout::LayoutWidget(World, WidgetClass, Record.AssetPath, Resolutions, SafeZoneRatio, BoxOffset, Results);
+			}
+		}
+
+		if (0 == (i + 1) % GuideMaskLayout::GarbageCollectInterval)
+		{
+			CollectGarbage(RF_NoFlags);
+		}
+	}
+
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+
+	int32 ErrorCount = 0;
+	int32 WarningCount = 0;
+
+	for (const FGuideLayoutResult& Result : Results)
+	{
+		for (const FGuideValidationIssue& Issue : Result.Issues)
+		{
+			if (FGuideValidationIssue::ESeverity::Error == Issue.Severity)
+			{
+				++ErrorCount;
+				UE_LOG(LogGuideMaskLayout, Error, TEXT("[%s] %s %dx%d@%.2f : %s"),
+					*Issue.Code, *Result.AssetPath, Result.Resolution.X, Result.Resolution.Y, Result.DPIScale, *Issue.Message);
+			}
+
+			else
+			{
+				++WarningCount;
+				UE_LOG(LogGuideMaskLayout, Warning, TEXT("[%s] %s %dx%d@%.2f : %s"),
+					*Issue.Code, *Result.AssetPath, Result.Resolution.X, Result.Resolution.Y, Result.DPIScale, *Issue.Message);
+			}
+		}
+	}
+
+	WriteReport(ReportPath, Results, Assets.Num());
+
+	UE_LOG(LogGuideMaskLayout, Display, TEXT("%d layouts checked, %d errors, %d warnings. Report : %s"),
+		Results.Num(), ErrorCount, WarningCount, *ReportPath);
+
+	return ErrorCount > 0 ? 1 : 0;
+}
+
+bool UGuideMaskLayoutCommandlet::WriteReport(const FString& InReportPath, const TArray<FGuideLayoutResult>& InResults, int32 InScannedCount) const
+{
+	FString Output;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+
+	int32 ErrorCount = 0;
+	int32 WarningCount = 0;
+
+	Writer->WriteObjectStart();
+	Writer->WriteArrayStart(TEXT("layouts"));
+
+	for (const FGuideLayoutResult& Result : InResults)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("path"), Result.AssetPath);
+		Writer->WriteValue(TEXT("resolution"), FString::Printf(TEXT("%dx%d"), Result.Resolution.X, Result.Resolution.Y));
+		Writer->WriteValue(TEXT("dpiScale"), Result.DPIScale);
+
+		Writer->WriteArrayStart(TEXT("rects"));
+		for (const FGuideLayoutRect& Rect : Result.Rects)
+		{
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("tag"), Rect.Tag.ToString());
+			Writer->WriteValue(TEXT("x"), Rect.Position.X);
+			Writer->WriteValue(TEXT("y"), Rect.Position.Y);
+			Writer->WriteValue(TEXT("width"), Rect.Size.X);
+			Writer->WriteValue(TEXT("height"), Rect.Size.Y);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+
+		Writer->WriteArrayStart(TEXT("issues"));
+		for (const FGuideValidationIssue& Issue : Result.Issues)
+		{
+			const bool bError = FGuideValidationIssue::ESeverity::Error == Issue.Severity;
+			bError ? ++ErrorCount : ++WarningCount;
+
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("severity"), bError ? TEXT("error") : TEXT("warning"));
+			Writer->WriteValue(TEXT("code"), Issue.Code);
+			Writer->WriteValue(TEXT("tag"), Issue.Tag.ToString());
+			Writer->WriteValue(TEXT("message"), Issue.Message);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectStart(TEXT("summary"));
+	Writer->WriteValue(TEXT("scannedBlueprints"), InScannedCount);
+	Writer->WriteValue(TEXT("layouts"), InResults.Num());
+	Writer->WriteValue(TEXT("errors"), ErrorCount);
+	Writer->WriteValue(TEXT("warnings"), WarningCount);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (false == FFileHelper::SaveStringToFile(Output, *InReportPath))
+	{
+		UE_LOG(LogGuideMaskLayout, Error, TEXT("Failed to write report : %s"), *InReportPath);
+		return false;
+	}
+
+	return true;
+}
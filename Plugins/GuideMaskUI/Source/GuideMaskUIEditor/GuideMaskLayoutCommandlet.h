@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GuideMaskLayoutCommandlet.generated.h"
+
+struct FGuideLayoutResult;
+
+/**
+ * Lays out every guide screen at a list of resolutions without rendering and checks the guide rect of each tag.
+ *
+ * UnrealEditor-Cmd.exe <Project> -run=GuideMaskLayout [-Path=/Game] [-Report=<File.json>] [-All]
+ *     [-Resolutions=1920x1080,2732x2048@2.0,...] [-SafeZone=<TitleRatio>]
+ *
+ * Rects go through the same math as the guide layer, the box offset is clamped to the safe zone the same way. A resolution without @ takes its DPI scale from the project DPI curve.
+ * -SafeZone is the title safe ratio. Without it r.DebugSafeZone.TitleRatio is used when set, otherwise 0.9.
+ * Targets off the screen are errors, targets clipped by the safe zone or overlapping another target are warnings.
+ * Returns 1 when any error was found.
+ */
+UCLASS()
+class GUIDEMASKUIEDITOR_API UGuideMaskLayoutCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGuideMaskLayoutCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	bool WriteReport(const FString& InReportPath, const TArray<FGuideLayoutResult>& InResults, int32 InScannedCount) const;
+};
@@ -9,6 +9,7 @@
 #include "IDetailChildrenBuilder.h"
 
 #include "GuideMaskUI/UI/GuideMaskRegister.h"
+#include "SGuideHierarchyTreeView.h"
 
 
 const FName PreviewOptionCategoryName = FName(TEXT("Guide Mask Preview Option"));
@@ -26,7 +27,6 @@ void FGuideMaskRegDetailCustomization::CustomizeDetails(IDetailLayoutBuilder& De
 {
     IDetailCategoryBuilder& PreviewCategory = DetailBuilder.EditCategory(PreviewOptionCategoryName);
     RegistProperty(DetailBuilder, PreviewCategory, FName("PreviewTag"), UGuideMaskRegister::StaticClass());
-    RegisterPropertyChangedFullRefresh(DetailBuilder, FName("PreviewTag"));
 
     RegistProperty(DetailBuilder, PreviewCategory, FName("PreviewWidget"), UGuideMaskRegister::StaticClass());
 
@@ -42,12 +42,6 @@ void FGuideMaskRegDetailCustomization::CustomizeDetails(IDetailLayoutBuilder& De
     DetailBuilder.SortCategories(&SortCustomDetailsCategories);
 }
 
-void FGuideMaskRegDetailCustomization::CustomizeDetails(const TSharedPtr<IDetailLayoutBuilder>& DetailBuilder)
-{
-    CachedDetailBuilder = DetailBuilder;
-    CustomizeDetails(*DetailBuilder);
-}
-
 void FGuideMaskRegDetailCustomization::RegistProperty(IDetailLayoutBuilder& DetailBuilder, IDetailCategoryBuilder& InCategoryBuilder, const FName& InProperty, const UStruct* ClassOutermost, bool bShouldAutoExpand)
 {
     TSharedRef<IPropertyHandle> PropertyHandle = DetailBuilder.GetProperty(InProperty, ClassOutermost);
@@ -60,58 +54,17 @@ void FGuideMaskRegDetailCustomization::RegistHierarchyProperty(IDetailLayoutBuil
     TSharedRef<IPropertyHandle> PropertyHandle = DetailBuilder.GetProperty(InProperty, ClassOutermost);
     DetailBuilder.HideProperty(PropertyHandle);
 
-    uint32 Num = 0;
-    if (auto Array = PropertyHandle->AsArray())
-    {
-        Array->GetNumElements(Num);
-    }
-
-
-    if (Num == 0)
-    {
-        InCategoryBuilder.AddCustomRow(FText::FromString("HierarchyEmpty"))
-            .WholeRowContent()
-            [
-                SNew(STextBlock)
-                    .Text(FText::FromString(TEXT("Hierarchy is Empty.")))
-                    .AutoWrapText(true)
-            ];
-    }
-
-    else
-    {
-
-        TSharedRef<FDetailArrayBuilder> ArrayBuilder =
-            MakeShared<FDetailArrayBuilder>(PropertyHandle, /*bGenerateHeader*/ false);
-
-        ArrayBuilder->OnGenerateArrayElementWidget(
-            FOnGenerateArrayElementWidget::CreateLambda(
-                [](TSharedRef<IPropertyHandle> ElementHandle, int32 Index, IDetailChildrenBuilder& Children)
-                {
-                    IDetailPropertyRow& Row = Children.AddProperty(ElementHandle);
-                    Row.ShowPropertyButtons(false);
-                    Row.IsEnabled(false);
-                })
-        );
-
-        InCategoryBuilder.AddCustomBuilder(ArrayBuilder);
-    }
-}
-
-void FGuideMaskRegDetailCustomization::RegisterPropertyChangedFullRefresh(IDetailLayoutBuilder& DetailBuilder, const FName Property)
-{
-    const TSharedPtr<IPropertyHandle> PropertyHandle = DetailBuilder.GetProperty(Property);
-    PropertyHandle.Get()->SetOnPropertyValueChanged(FSimpleDelegate::CreateSP(this, &FGuideMaskRegDetailCustomization::ForceRefreshDetailPanel));
-    PropertyHandle.Get()->SetOnChildPropertyValueChanged(FSimpleDelegate::CreateSP(this, &FGuideMaskRegDetailCustomization::ForceRefreshDetailPanel));
-}
+    TArray<TWeakObjectPtr<UObject>> Objects;
+    DetailBuilder.GetObjectsBeingCustomized(Objects);
 
-void FGuideMaskRegDetailCustomization::ForceRefreshDetailPanel()
-{
-    if (IDetailLayoutBuilder* DetailBuilder = CachedDetailBuilder.Pin().Get())
+    UGuideMaskRegister* Register = 0 < Objects.Num() ? Cast<UGuideMaskRegister>(Objects[0].Get()) : nullptr;
 
-    {
-        DetailBuilder->ForceRefreshDetails();
-    }
+    // The tree follows the register's hierarchy changes by itself, no details refresh needed.
+    InCategoryBuilder.AddCustomRow(FText::FromString("Hierarchy"))
+        .WholeRowContent()
+        [
+            SNew(SGuideHierarchyTreeView, Register)
+        ];
 }
 
 void FGuideMaskRegDetailCustomization::SortCustomDetailsCategories(const TMap<FName, IDetailCategoryBuilder*>& AllCategoryMap)
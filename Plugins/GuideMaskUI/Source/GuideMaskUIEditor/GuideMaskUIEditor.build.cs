@@ -41,8 +41,14 @@ public class GuideMaskUIEditor : ModuleRules
                 "PropertyEditor",
 				"Slate",
 				"SlateCore",
+				"SlateNullRenderer",
 				"UMG",
-                "UnrealEd"
+                "UMGEditor",
+                "UnrealEd",
+                "AssetRegistry",
+                "Json",
+                "BlueprintGraph",
+                "WorkspaceMenuStructure"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -5,8 +5,18 @@
 #include "Modules/ModuleManager.h"
 #include "GuideHierarchyNodeCustomization.h"
 #include "GuideMaskRegDetailCustomization.h"
+#include "GuideMaskAssetTags.h"
+#include "SGuideTagBrowser.h"
 #include "GuideMaskUI/UI/GuideMaskRegister.h"
 
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Docking/TabManager.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "WorkspaceMenuStructure.h"
+#include "WorkspaceMenuStructureModule.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+
 class FGuideMaskUIEditorModule : public IModuleInterface
 {
 public:
@@ -14,6 +24,18 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	TSharedRef<SDockTab> SpawnTagBrowserTab(const FSpawnTabArgs& InArgs);
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+	void OnGetExtraObjectTags(FAssetRegistryTagsContext InContext);
+#else
+	void OnGetExtraObjectTags(const UObject* InObject, TArray<UObject::FAssetRegistryTag>& OutTags);
+#endif
+
+private:
+	FDelegateHandle ExtraObjectTagsHandle;
 };
 
 
@@ -26,6 +48,17 @@ void FGuideMaskUIEditorModule::StartupModule()
 	FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
 	PropertyModule.RegisterCustomPropertyTypeLayout(FGuideHierarchyNode::StaticStruct()->GetFName(), FOnGetPropertyTypeCustomizationInstance::CreateStatic(&FGuideHierarchyNodeCustomization::MakeInstance));
 	PropertyModule.RegisterCustomClassLayout(UGuideMaskRegister::StaticClass()->GetFName(), FOnGetDetailCustomizationInstance::CreateStatic(&FGuideMaskRegDetailCustomization::MakeInstance));
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+	ExtraObjectTagsHandle = UObject::FAssetRegistryTag::OnGetExtraObjectTagsWithContext.AddRaw(this, &FGuideMaskUIEditorModule::OnGetExtraObjectTags);
+#else
+	ExtraObjectTagsHandle = UObject::FAssetRegistryTag::OnGetExtraObjectTags.AddRaw(this, &FGuideMaskUIEditorModule::OnGetExtraObjectTags);
+#endif
+
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(SGuideTagBrowser::TabName, FOnSpawnTab::CreateRaw(this, &FGuideMaskUIEditorModule::SpawnTagBrowserTab))
+		.SetDisplayName(LOCTEXT("TagBrowserTitle", "Guide Tag Browser"))
+		.SetTooltipText(LOCTEXT("TagBrowserTooltip", "List every guide tag of the project."))
+		.SetGroup(WorkspaceMenu::GetMenuStructure().GetDeveloperToolsMiscCategory());
 }
 
 void FGuideMaskUIEditorModule::ShutdownModule()
@@ -36,7 +69,45 @@ void FGuideMaskUIEditorModule::ShutdownModule()
 	FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
 	PropertyModule.UnregisterCustomPropertyTypeLayout(FGuideHierarchyNode::StaticStruct()->GetFName());
 	PropertyModule.UnregisterCustomClassLayout(UGuideMaskRegister::StaticClass()->GetFName());
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+	UObject::FAssetRegistryTag::OnGetExtraObjectTagsWithContext.Remove(ExtraObjectTagsHandle);
+#else
+	UObject::FAssetRegistryTag::OnGetExtraObjectTags.Remove(ExtraObjectTagsHandle);
+#endif
+
+	if (FSlateApplication::IsInitialized())
+	{
+		FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(SGuideTagBrowser::TabName);
+	}
+}
+
+TSharedRef<SDockTab> FGuideMaskUIEditorModule::SpawnTagBrowserTab(const FSpawnTabArgs& InArgs)
+{
+	return SNew(SDockTab)
+		.TabRole(ETabRole::NomadTab)
+		[
+			SNew(SGuideTagBrowser)
+		];
+}
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+void FGuideMaskUIEditorModule::OnGetExtraObjectTags(FAssetRegistryTagsContext InContext)
+{
+	TArray<UObject::FAssetRegistryTag> Tags;
+	FGuideMaskAssetTags::GetAssetRegistryTags(InContext.GetObject(), Tags);
+
+	for (const UObject::FAssetRegistryTag& Tag : Tags)
+	{
+		InContext.AddTag(Tag);
+	}
+}
+#else
+void FGuideMaskUIEditorModule::OnGetExtraObjectTags(const UObject* InObject, TArray<UObject::FAssetRegistryTag>& OutTags)
+{
+	FGuideMaskAssetTags::GetAssetRegistryTags(InObject, OutTags);
 }
+#endif
 
 #undef LOCTEXT_NAMESPACE
 	
@@ -0,0 +1,268 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GuideMaskValidateCommandlet.h"
+#include "GuideMaskAssetScan.h"
+
+#include "WidgetBlueprint.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION >= 5
+#include "AssetRegistry/AssetRegistryModule.h"
+#else
+#include "AssetRegistryModule.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogGuideMaskValidate, Log, All);
+
+namespace GuideMaskValidate
+{
+	// Loaded blueprints are released every N assets so a full project scan stays within memory.
+	constexpr int32 GarbageCollectInterval = 100;
+
+	const FName GuideMaskScriptPackage = FName(TEXT("/Script/GuideMaskUI"));
+}
+
+
+UGuideMaskValidateCommandlet::UGuideMaskValidateCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Validates guide mask registers of every widget blueprint and writes a json report.");
+	HelpUsage = TEXT("-run=GuideMaskValidate [-Path=/Game] [-Report=<File.json>] [-All]");
+}
+
+int32 UGuideMaskValidateCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamMap);
+
+	const FString SearchPath = ParamMap.Contains(TEXT("Path")) ? ParamMap[TEXT("Path")] : TEXT("/Game");
+	const FString ReportPath = ParamMap.Contains(TEXT("Report")) ? ParamMap[TEXT("Report")] : FPaths::ProjectSavedDir() / TEXT("GuideMask") / TEXT("GuideMaskValidation.json");
+	const bool bScanAll = Switches.Contains(TEXT("All"));
+
+	TArray<FAssetData> Assets;
+	GatherWidgetBlueprints(SearchPath, bScanAll, Assets);
+
+	UE_LOG(LogGuideMaskValidate, Display, TEXT("Scanning %d widget blueprints under %s"), Assets.Num(), *SearchPath);
+
+
+	// UObject part. Loading and reading the widget trees has to stay on the game thread.
+	TArray<FGuideBlueprintRecord> Records;
+
+	for (int32 i = 0; i < Assets.Num(); ++i)
+	{
+		FGuideBlueprintRecord Record;
+		if (true == FGuideMaskAssetScan::CollectBlueprintRecord(Cast<UWidgetBlueprint>(Assets[i].GetAsset()), Record) && Record.RegisterCount > 0)
+		{
+			Records.Emplace(MoveTemp(Record));
+		}
+
+		if (0 == (i + 1) % GuideMaskValidate::GarbageCollectInterval)
+		{
+			CollectGarbage(RF_NoFlags);
+		}
+	}
+
+
+	// Non-UObject part. Records are plain data from here on.
+	TArray<TArray<FGuideValidationIssue>> Issues;
+	Issues.SetNum(Records.Num());
+
+	ParallelFor(Records.Num(), [&Records, &Issues](int32 Index)
+		{
+			FGuideMaskAssetScan::ValidateRecord(Records[Index], Issues[Index]);
+		});
+
+	ValidateDuplicateTags(Records, Issues);
+
+
+	int32 ErrorCount = 0;
+	int32 WarningCount = 0;
+
+	for (int32 i = 0; i < Records.Num(); ++i)
+	{
+		for (const FGuideValidationIssue& Issue : Issues[i])
+		{
+			if (FGuideValidationIssue::ESeverity::Error == Issue.Severity)
+			{
+				++ErrorCount;
+				UE_LOG(LogGuideMaskValidate, Error, TEXT("[%s] %s : %s"), *Issue.Code, *Records[i].AssetPath, *Issue.Message);
+			}
+
+			else
+			{
+				++WarningCount;
+				UE_LOG(LogGuideMaskValidate, Warning, TEXT("[%s] %s : %s"), *Issue.Code, *Records[i].AssetPath, *Issue.Message);
+			}
+		}
+	}
+
+	WriteReport(ReportPath, Records, Issues, Assets.Num());
+
+	UE_LOG(LogGuideMaskValidate, Display, TEXT("%d registers validated, %d errors, %d warnings. Report : %s"),
+		Records.Num(), ErrorCount, WarningCount, *ReportPath);
+
+	return ErrorCount > 0 ? 1 : 0;
+}
+
+void UGuideMaskValidateCommandlet::GatherWidgetBlueprints(const FString& InSearchPath, bool bInScanAll, TArray<FAssetData>& OutAssets)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.PackagePaths.Add(FName(*InSearchPath));
+	Filter.bRecursivePaths = true;
+	Filter.bRecursiveClasses = true;
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+	Filter.ClassPaths.Add(UWidgetBlueprint::StaticClass()->GetClassPathName());
+#else
+	Filter.ClassNames.Add(UWidgetBlueprint::StaticClass()->GetFName());
+#endif
+
+	// Only blueprints importing the plugin script package can own a register, so skip loading the rest.
+	if (false == bInScanAll)
+	{
+		TArray<FName> Referencers;
+		AssetRegistry.GetReferencers(GuideMaskValidate::GuideMaskScriptPackage, Referencers);
+
+		if (0 < Referencers.Num())
+		{
+			Filter.PackageNames = MoveTemp(Referencers);
+		}
+
+		else
+		{
+			UE_LOG(LogGuideMaskValidate, Warning, TEXT("No referencers of %s in the asset registry, scanning every widget blueprint."),
+				*GuideMaskValidate::GuideMaskScriptPackage.ToString());
+		}
+	}
+
+	AssetRegistry.GetAssets(Filter, OutAssets);
+}
+
+void UGuideMaskValidateCommandlet::ValidateDuplicateTags(const TArray<FGuideBlueprintRecord>& InRecords, TArray<TArray<FGuideValidationIssue>>& InOutIssues) const
+{
+	TMap<FName, TArray<int32>> TagOwners;
+
+	for (int32 i = 0; i < InRecords.Num(); ++i)
+	{
+		for (const FGuideTagRecord& Tag : InRecords[i].Tags)
+		{
+			if (false == Tag.Tag.IsNone())
+			{
+				TagOwners.FindOrAdd(Tag.Tag).AddUnique(i);
+			}
+		}
+	}
+
+	// GetRegister returns the first register containing a tag, so a tag shared by two screens is ambiguous.
+	for (const TPair<FName, TArray<int32>>& Pair : TagOwners)
+	{
+		if (Pair.Value.Num() <= 1)
+		{
+			continue;
+		}
+
+		TArray<FString> OwnerPaths;
+		for (int32 Owner : Pair.Value)
+		{
+			OwnerPaths.Emplace(InRecords[Owner].AssetPath);
+		}
+
+		const FString Message = FString::Printf(TEXT("Tag %s is registered in %d screens : %s"),
+			*Pair.Key.ToString(), OwnerPaths.Num(), *FString::Join(OwnerPaths, TEXT(", ")));
+
+		for (int32 Owner : Pair.Value)
+		{
+			FGuideValidationIssue& Issue = InOutIssues[Owner].AddDefaulted_GetRef();
+			Issue.Severity = FGuideValidationIssue::ESeverity::Error;
+			Issue.Code = TEXT("DuplicateTag");
+			Issue.Message = Message;
+			Issue.Tag = Pair.Key;
+		}
+	}
+}
+
+bool UGuideMaskValidateCommandlet::WriteReport(const FString& InReportPath, const TArray<FGuideBlueprintRecord>& InRecords, const TArray<TArray<FGuideValidationIssue>>& InIssues, int32 InScannedCount) const
+{
+	FString Output;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+
+	int32 ErrorCount = 0;
+	int32 WarningCount = 0;
+
+	Writer->WriteObjectStart();
+	Writer->WriteArrayStart(TEXT("assets"));
+
+	for (int32 i = 0; i < InRecords.Num(); ++i)
+	{
+		const FGuideBlueprintRecord& Record = InRecords[i];
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("path"), Record.AssetPath);
+		Writer->WriteValue(TEXT("registers"), Record.RegisterCount);
+
+		Writer->WriteArrayStart(TEXT("tags"));
+		for (const FGuideTagRecord& Tag : Record.Tags)
+		{
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("tag"), Tag.Tag.ToString());
+			Writer->WriteValue(TEXT("widget"), Tag.WidgetName);
+			Writer->WriteValue(TEXT("widgetClass"), Tag.WidgetClass);
+			Writer->WriteValue(TEXT("entryClass"), Tag.EntryClass);
+			Writer->WriteValue(TEXT("containerDepth"), Tag.ContainerDepth);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+
+		Writer->WriteArrayStart(TEXT("issues"));
+		for (const FGuideValidationIssue& Issue : InIssues[i])
+		{
+			const bool bError = FGuideValidationIssue::ESeverity::Error == Issue.Severity;
+			bError ? ++ErrorCount : ++WarningCount;
+
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("severity"), bError ? TEXT("error") : TEXT("warning"));
+			Writer->WriteValue(TEXT("code"), Issue.Code);
+			Writer->WriteValue(TEXT("tag"), Issue.Tag.ToString());
+			Writer->WriteValue(TEXT("message"), Issue.Message);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectStart(TEXT("summary"));
+	Writer->WriteValue(TEXT("scannedBlueprints"), InScannedCount);
+	Writer->WriteValue(TEXT("registerBlueprints"), InRecords.Num());
+	Writer->WriteValue(TEXT("errors"), ErrorCount);
+	Writer->WriteValue(TEXT("warnings"), WarningCount);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (false == FFileHelper::SaveStringToFile(Output, *InReportPath))
+	{
+		UE_LOG(LogGuideMaskValidate, Error, TEXT("Failed to write report : %s"), *InReportPath);
+		return false;
+	}
+
+	return true;
+}
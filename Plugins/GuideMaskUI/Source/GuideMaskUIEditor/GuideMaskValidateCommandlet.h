@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GuideMaskValidateCommandlet.generated.h"
+
+struct FAssetData;
+struct FGuideBlueprintRecord;
+struct FGuideValidationIssue;
+
+/**
+ * Validates guide registration of every widget blueprint in the project.
+ *
+ * UnrealEditor-Cmd.exe <Project> -run=GuideMaskValidate [-Path=/Game] [-Report=<File.json>] [-All]
+ *
+ * -All skips the asset registry pre-filter and loads every widget blueprint under -Path.
+ * Returns 1 when any error was found, so it can gate a build.
+ */
+UCLASS()
+class GUIDEMASKUIEDITOR_API UGuideMaskValidateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGuideMaskValidateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/** Widget blueprints under the path. Without bInScanAll only the ones referencing the plugin. Shared with the layout check. */
+	static void GatherWidgetBlueprints(const FString& InSearchPath, bool bInScanAll, TArray<FAssetData>& OutAssets);
+
+private:
+	void ValidateDuplicateTags(const TArray<FGuideBlueprintRecord>& InRecords, TArray<TArray<FGuideValidationIssue>>& InOutIssues) const;
+	bool WriteReport(const FString& InReportPath, const TArray<FGuideBlueprintRecord>& InRecords, const TArray<TArray<FGuideValidationIssue>>& InIssues, int32 InScannedCount) const;
+};
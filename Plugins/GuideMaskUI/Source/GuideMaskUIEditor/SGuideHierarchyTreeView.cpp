@@ -0,0 +1,341 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SGuideHierarchyTreeView.h"
+#include "GuideHierarchyNodeCustomization.h"
+
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+
+#include "Components/Widget.h"
+#include "GuideMaskUI/UI/GuideMaskRegister.h"
+
+#define LOCTEXT_NAMESPACE "SGuideHierarchyTreeView"
+
+SGuideHierarchyTreeView::~SGuideHierarchyTreeView()
+{
+	if (UGuideMaskRegister* RegisterPtr = Register.Get())
+	{
+		RegisterPtr->OnPreviewHierarchyChanged.Remove(HierarchyChangedHandle);
+	}
+}
+
+void SGuideHierarchyTreeView::Construct(const FArguments& InArgs, UGuideMaskRegister* InRegister)
+{
+	Register = InRegister;
+
+	if (nullptr != InRegister)
+	{
+		HierarchyChangedHandle = InRegister->OnPreviewHierarchyChanged.AddSP(this, &SGuideHierarchyTreeView::OnHierarchyChanged);
+	}
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot().AutoHeight().Padding(0, 0, 0, 4)
+		[
+			SNew(SSearchBox)
+				.HintText(LOCTEXT("SearchHint", "Search by widget name"))
+				.OnTextChanged(this, &SGuideHierarchyTreeView::OnFilterTextChanged)
+		]
+		+ SVerticalBox::Slot().AutoHeight()
+		[
+			SNew(STextBlock)
+				.Text(LOCTEXT("HierarchyEmpty", "Hierarchy is Empty."))
+				.AutoWrapText(true)
+				.Visibility_Lambda([this]()
+					{
+						return 0 < RootItems.Num() ? EVisibility::Collapsed : EVisibility::Visible;
+					})
+		]
+		+ SVerticalBox::Slot().AutoHeight()
+		[
+			// Bounded height keeps the tree virtualized inside the details panel.
+			SNew(SBox)
+				.MaxDesiredHeight(300.f)
+				.Visibility_Lambda([this]()
+					{
+						return 0 < RootItems.Num() ? EVisibility::Visible : EVisibility::Collapsed;
+					})
+				[
+					SAssignNew(TreeView, STreeView<FTreeItemPtr>)
+						.TreeItemsSource(&RootItems)
+						.SelectionMode(ESelectionMode::Single)
+						.OnGenerateRow(this, &SGuideHierarchyTreeView::OnGenerateRow)
+						.OnGetChildren(this, &SGuideHierarchyTreeView::OnGetChildren)
+						.OnExpansionChanged(this, &SGuideHierarchyTreeView::OnExpansionChanged)
+				]
+		]
+	];
+
+	RebuildItems();
+}
+
+void SGuideHierarchyTreeView::RebuildItems()
+{
+	RootItems.Reset();
+	ContainerNodeIndex.Reset();
+	ParentContainer.Reset();
+
+	if (UGuideMaskRegister* RegisterPtr = Register.Get())
+	{
+		const TArray<FGuideHierarchyNode>& Hierarchy = RegisterPtr->GetPreviewHierarchy();
+
+		for (int32 i = 0; i < Hierarchy.Num(); ++i)
+		{
+			UWidget* Container = Hierarchy[i].Container;
+			if (nullptr == Container)
+			{
+				continue;
+			}
+
+			if (false == ContainerNodeIndex.Contains(Container))
+			{
+				ContainerNodeIndex.Emplace(Container, i);
+			}
+
+			for (UWidget* Child : Hierarchy[i].Children)
+			{
+				if (nullptr != Child && false == ParentContainer.Contains(Child))
+				{
+					ParentContainer.Emplace(Child, Container);
+				}
+			}
+		}
+
+		if (0 < Hierarchy.Num() && nullptr != Hierarchy[0].Container)
+		{
+			RootItems.Emplace(MakeItem(Hierarchy[0].Container));
+		}
+	}
+
+	if (true == bInitialExpand && 0 < RootItems.Num())
+	{
+		bInitialExpand = false;
+
+		for (const FTreeItemPtr& Root : RootItems)
+		{
+			ExpandedWidgets.Add(Root->Widget);
+		}
+	}
+
+	RebuildFilter();
+	RefreshExpansion();
+}
+
+void SGuideHierarchyTreeView::RebuildFilter()
+{
+	FilterVisibleWidgets.Reset();
+
+	UGuideMaskRegister* RegisterPtr = Register.Get();
+	if (true == FilterText.IsEmpty() || nullptr == RegisterPtr)
+	{
+		return;
+	}
+
+	const FString Filter = FilterText.ToString();
+
+	auto AddMatch = [this, &Filter](UWidget* InWidget)
+		{
+			if (nullptr == InWidget || false == InWidget->GetName().Contains(Filter))
+			{
+				return;
+			}
+
+			// A match keeps the whole container chain above it visible.
+			TWeakObjectPtr<UWidget> Current = InWidget;
+			while (Current.IsValid() && false == FilterVisibleWidgets.Contains(Current))
+			{
+				FilterVisibleWidgets.Add(Current);
+				Current = ParentContainer.FindRef(Current);
+			}
+		};
+
+	for (const FGuideHierarchyNode& Node : RegisterPtr->GetPreviewHierarchy())
+	{
+		AddMatch(Node.Container);
+
+		for (UWidget* Child : Node.Children)
+		{
+			AddMatch(Child);
+		}
+	}
+}
+
+void SGuideHierarchyTreeView::RefreshExpansion()
+{
+	if (false == TreeView.IsValid())
+	{
+		return;
+	}
+
+	TGuardValue<bool> Guard(bRestoringExpansion, true);
+
+	TreeView->ClearExpandedItems();
+	RestoreExpansion(RootItems);
+	TreeView->RequestTreeRefresh();
+}
+
+void SGuideHierarchyTreeView::RestoreExpansion(const TArray<FTreeItemPtr>& InItems)
+{
+	const bool bFiltering = false == FilterText.IsEmpty();
+
+	for (const FTreeItemPtr& Item : InItems)
+	{
+		if (false == Item.IsValid() || INDEX_NONE == Item->NodeIndex)
+		{
+			continue;
+		}
+
+		const bool bExpand = bFiltering ? FilterVisibleWidgets.Contains(Item->Widget) : ExpandedWidgets.Contains(Item->Widget);
+		if (false == bExpand)
+		{
+			continue;
+		}
+
+		TreeView->SetItemExpansion(Item, true);
+
+		BuildChildren(Item);
+		RestoreExpansion(Item->Children);
+	}
+}
+
+SGuideHierarchyTreeView::FTreeItemPtr SGuideHierarchyTreeView::MakeItem(UWidget* InWidget) const
+{
+	FTreeItemPtr Item = MakeShared<FGuideHierarchyTreeItem>();
+	Item->Widget = InWidget;
+
+	if (const int32* NodeIndex = ContainerNodeIndex.Find(InWidget))
+	{
+		Item->NodeIndex = *NodeIndex;
+	}
+
+	return Item;
+}
+
+void SGuideHierarchyTreeView::BuildChildren(const FTreeItemPtr& InItem) const
+{
+	if (true == InItem->bChildrenBuilt)
+	{
+		return;
+	}
+
+	InItem->bChildrenBuilt = true;
+
+	UGuideMaskRegister* RegisterPtr = Register.Get();
+	if (nullptr == RegisterPtr || INDEX_NONE == InItem->NodeIndex)
+	{
+		return;
+	}
+
+	const TArray<FGuideHierarchyNode>& Hierarchy = RegisterPtr->GetPreviewHierarchy();
+	if (false == Hierarchy.IsValidIndex(InItem->NodeIndex))
+	{
+		return;
+	}
+
+	for (UWidget* Child : Hierarchy[InItem->NodeIndex].Children)
+	{
+		if (nullptr != Child)
+		{
+			InItem->Children.Emplace(MakeItem(Child));
+		}
+	}
+}
+
+bool SGuideHierarchyTreeView::IsVisibleItem(const FTreeItemPtr& InItem) const
+{
+	return true == FilterText.IsEmpty() || FilterVisibleWidgets.Contains(InItem->Widget);
+}
+
+TSharedRef<ITableRow> SGuideHierarchyTreeView::OnGenerateRow(FTreeItemPtr InItem, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	UWidget* Widget = InItem->Widget.Get();
+	UClass* EntryClass = UGuideMaskRegister::GetContainerEntryClass(Widget);
+
+	const FText NameText = nullptr != Widget ? FText::FromName(Widget->GetFName()) : FText::FromString(TEXT("nullptr!"));
+	const FText ClassText = nullptr != EntryClass ?
+		FText::FromString(FString::Printf(TEXT("(Entry: %s)"), *EntryClass->GetName())) :
+		FText::FromString(nullptr != Widget ? Widget->GetClass()->GetName() : TEXT("None"));
+
+	TWeakObjectPtr<UWidget> WeakWidget = Widget;
+
+	return SNew(STableRow<FTreeItemPtr>, OwnerTable)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().AutoWidth().VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+					.Text(NameText)
+					.HighlightText_Lambda([this]()
+						{
+							return FilterText;
+						})
+			]
+			+ SHorizontalBox::Slot().FillWidth(1.f).Padding(12, 0).VAlign(VAlign_Center)
+			[
+				SNew(STextBlock).Text(ClassText)
+			]
+			+ SHorizontalBox::Slot().AutoWidth().Padding(8, 0)
+			[
+				SNew(SButton)
+					.Visibility(nullptr != EntryClass ? EVisibility::Visible : EVisibility::Collapsed)
+					.Text(LOCTEXT("OpenEntryClass", "Open Entry Class BP"))
+					.OnClicked_Lambda([WeakWidget]()
+						{
+							return FGuideHierarchyNodeCustomization::OpenEntryClassBlueprint(UGuideMaskRegister::GetContainerEntryClass(WeakWidget.Get()));
+						})
+			]
+		];
+}
+
+void SGuideHierarchyTreeView::OnGetChildren(FTreeItemPtr InItem, TArray<FTreeItemPtr>& OutChildren)
+{
+	BuildChildren(InItem);
+
+	for (const FTreeItemPtr& Child : InItem->Children)
+	{
+		if (true == IsVisibleItem(Child))
+		{
+			OutChildren.Emplace(Child);
+		}
+	}
+}
+
+void SGuideHierarchyTreeView::OnExpansionChanged(FTreeItemPtr InItem, bool bExpanded)
+{
+	// Expansion made by the search or by restoring isn't remembered.
+	if (true == bRestoringExpansion || false == FilterText.IsEmpty() || false == InItem.IsValid())
+	{
+		return;
+	}
+
+	if (true == bExpanded)
+	{
+		ExpandedWidgets.Add(InItem->Widget);
+	}
+
+	else
+	{
+		ExpandedWidgets.Remove(InItem->Widget);
+	}
+}
+
+void SGuideHierarchyTreeView::OnFilterTextChanged(const FText& InText)
+{
+	FilterText = InText;
+
+	RebuildFilter();
+	RefreshExpansion();
+}
+
+void SGuideHierarchyTreeView::OnHierarchyChanged()
+{
+	RebuildItems();
+}
+
+#undef LOCTEXT_NAMESPACE
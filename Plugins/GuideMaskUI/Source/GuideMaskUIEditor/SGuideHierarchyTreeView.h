@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/STreeView.h"
+
+class UGuideMaskRegister;
+class UWidget;
+
+struct FGuideHierarchyTreeItem
+{
+	TWeakObjectPtr<UWidget> Widget;
+
+	// Index of the hierarchy node this widget is the container of. INDEX_NONE for plain children.
+	int32 NodeIndex = INDEX_NONE;
+
+	// Built on first expansion.
+	TArray<TSharedPtr<FGuideHierarchyTreeItem>> Children;
+	bool bChildrenBuilt = false;
+};
+
+/**
+ * Virtualized view of UGuideMaskRegister::WidgetHierarchy.
+ * Rows are only generated for visible items and children only when their container is expanded.
+ */
+class SGuideHierarchyTreeView : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SGuideHierarchyTreeView) {}
+	SLATE_END_ARGS()
+
+	virtual ~SGuideHierarchyTreeView();
+
+	void Construct(const FArguments& InArgs, UGuideMaskRegister* InRegister);
+
+private:
+	typedef TSharedPtr<FGuideHierarchyTreeItem> FTreeItemPtr;
+
+	void RebuildItems();
+	void RebuildFilter();
+	void RefreshExpansion();
+	void RestoreExpansion(const TArray<FTreeItemPtr>& InItems);
+
+	FTreeItemPtr MakeItem(UWidget* InWidget) const;
+	void BuildChildren(const FTreeItemPtr& InItem) const;
+	bool IsVisibleItem(const FTreeItemPtr& InItem) const;
+
+	TSharedRef<ITableRow> OnGenerateRow(FTreeItemPtr InItem, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnGetChildren(FTreeItemPtr InItem, TArray<FTreeItemPtr>& OutChildren);
+	void OnExpansionChanged(FTreeItemPtr InItem, bool bExpanded);
+	void OnFilterTextChanged(const FText& InText);
+
+	void OnHierarchyChanged();
+
+private:
+	TWeakObjectPtr<UGuideMaskRegister> Register;
+	FDelegateHandle HierarchyChangedHandle;
+
+	TSharedPtr<STreeView<FTreeItemPtr>> TreeView;
+	TArray<FTreeItemPtr> RootItems;
+
+	TMap<TWeakObjectPtr<UWidget>, int32> ContainerNodeIndex;
+	TMap<TWeakObjectPtr<UWidget>, TWeakObjectPtr<UWidget>> ParentContainer;
+
+	TSet<TWeakObjectPtr<UWidget>> ExpandedWidgets;
+	TSet<TWeakObjectPtr<UWidget>> FilterVisibleWidgets;
+
+	FText FilterText;
+	bool bInitialExpand = true;
+	bool bRestoringExpansion = false;
+};
@@ -0,0 +1,433 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SGuideTagBrowser.h"
+#include "GuideMaskAssetTags.h"
+#include "GuideMaskAssetScan.h"
+#include "GuideHierarchyNodeCustomization.h"
+
+#include "Engine/Blueprint.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+#include "Widgets/Views/SHeaderRow.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION >= 5
+#include "AssetRegistry/AssetRegistryModule.h"
+#else
+#include "AssetRegistryModule.h"
+#endif
+
+#define LOCTEXT_NAMESPACE "SGuideTagBrowser"
+
+const FName SGuideTagBrowser::TabName = FName(TEXT("GuideMaskTagBrowser"));
+
+namespace GuideTagBrowser
+{
+	const FName ColumnTag = FName(TEXT("Tag"));
+	const FName ColumnBlueprint = FName(TEXT("Blueprint"));
+	const FName ColumnWidget = FName(TEXT("Widget"));
+	const FName ColumnClass = FName(TEXT("Class"));
+	const FName ColumnDepth = FName(TEXT("Depth"));
+	const FName ColumnReferencedBy = FName(TEXT("ReferencedBy"));
+}
+
+
+class SGuideTagBrowserRow : public SMultiColumnTableRow<TSharedPtr<FGuideTagBrowserItem>>
+{
+public:
+	SLATE_BEGIN_ARGS(SGuideTagBrowserRow) {}
+		SLATE_ATTRIBUTE(FText, HighlightText)
+		SLATE_EVENT(FOnClicked, OnOpenClicked)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FGuideTagBrowserItem> InItem)
+	{
+		Item = InItem;
+		HighlightText = InArgs._HighlightText;
+		OnOpenClicked = InArgs._OnOpenClicked;
+
+		SMultiColumnTableRow<TSharedPtr<FGuideTagBrowserItem>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& InColumnName) override
+	{
+		if (GuideTagBrowser::ColumnBlueprint == InColumnName)
+		{
+			return SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot().FillWidth(1.f).VAlign(VAlign_Center)
+				[
+					MakeText(FText::FromString(Item->BlueprintName), FText::FromString(Item->BlueprintPath.ToString()))
+				]
+				+ SHorizontalBox::Slot().AutoWidth().Padding(4, 0)
+				[
+					SNew(SButton)
+						.Text(LOCTEXT("OpenBlueprint", "Open"))
+						.OnClicked(OnOpenClicked)
+				];
+		}
+
+		else if (GuideTagBrowser::ColumnWidget == InColumnName)
+		{
+			return MakeText(FText::FromString(Item->WidgetName));
+		}
+
+		else if (GuideTagBrowser::ColumnClass == InColumnName)
+		{
+			return MakeText(FText::FromString(Item->WidgetClass));
+		}
+
+		else if (GuideTagBrowser::ColumnDepth == InColumnName)
+		{
+			return MakeText(FText::AsNumber(Item->ContainerDepth));
+		}
+
+		else if (GuideTagBrowser::ColumnReferencedBy == InColumnName)
+		{
+			const FString References = FString::Join(Item->ReferencedBy, TEXT(", "));
+			return MakeText(FText::FromString(References), FText::FromString(References));
+		}
+
+		return MakeText(FText::FromName(Item->Tag));
+	}
+
+private:
+	TSharedRef<SWidget> MakeText(const FText& InText, const FText& InToolTip = FText::GetEmpty())
+	{
+		return SNew(STextBlock)
+			.Text(InText)
+			.ToolTipText(InToolTip)
+			.HighlightText(HighlightText);
+	}
+
+private:
+	TSharedPtr<FGuideTagBrowserItem> Item;
+	TAttribute<FText> HighlightText;
+	FOnClicked OnOpenClicked;
+};
+
+
+SGuideTagBrowser::~SGuideTagBrowser()
+{
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		AssetRegistryModule->Get().OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistryModule->Get().OnAssetRemoved().Remove(AssetRemovedHandle);
+	}
+}
+
+void SGuideTagBrowser::Construct(const FArguments& InArgs)
+{
+	SortColumn = GuideTagBrowser::ColumnTag;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddSP(this, &SGuideTagBrowser::OnAssetChanged);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddSP(this, &SGuideTagBrowser::OnAssetChanged);
+
+	auto MakeColumn = [this](const FName& InColumn, const FText& InLabel, float InFillWidth)
+		{
+			return SHeaderRow::Column(InColumn)
+				.DefaultLabel(InLabel)
+				.FillWidth(InFillWidth)
+				.SortMode(this, &SGuideTagBrowser::GetSortMode, InColumn)
+				.OnSort(this, &SGuideTagBrowser::OnSortModeChanged);
+		};
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot().AutoHeight().Padding(4)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(1.f)
+			[
+				SNew(SSearchBox)
+					.HintText(LOCTEXT("SearchHint", "Search tags, blueprints, widgets, references"))
+					.OnTextChanged(this, &SGuideTagBrowser::OnFilterTextChanged)
+			]
+			+ SHorizontalBox::Slot().AutoWidth().Padding(4, 0, 0, 0)
+			[
+				SNew(SButton)
+					.Text(LOCTEXT("Refresh", "Refresh"))
+					.OnClicked(this, &SGuideTagBrowser::OnRefreshClicked)
+			]
+		]
+		+ SVerticalBox::Slot().AutoHeight().Padding(4, 0)
+		[
+			SNew(STextBlock)
+				.Text_Lambda([this]()
+					{
+						return FText::Format(LOCTEXT("ItemCount", "{0} / {1} tags. Assets saved before this tool list their tags after a resave."),
+							FText::AsNumber(FilteredItems.Num()), FText::AsNumber(AllItems.Num()));
+					})
+		]
+		+ SVerticalBox::Slot().FillHeight(1.f).Padding(4)
+		[
+			SAssignNew(ListView, SListView<FItemPtr>)
+				.ListItemsSource(&FilteredItems)
+				.SelectionMode(ESelectionMode::Single)
+				.OnGenerateRow(this, &SGuideTagBrowser::OnGenerateRow)
+				.OnMouseButtonDoubleClick(this, &SGuideTagBrowser::OnItemDoubleClicked)
+				.HeaderRow
+				(
+					SNew(SHeaderRow)
+					+ MakeColumn(GuideTagBrowser::ColumnTag, LOCTEXT("ColumnTag", "Tag"), 0.15f)
+					+ MakeColumn(GuideTagBrowser::ColumnBlueprint, LOCTEXT("ColumnBlueprint", "Owning Blueprint"), 0.2f)
+					+ MakeColumn(GuideTagBrowser::ColumnWidget, LOCTEXT("ColumnWidget", "Widget"), 0.15f)
+					+ MakeColumn(GuideTagBrowser::ColumnClass, LOCTEXT("ColumnClass", "Widget Type"), 0.15f)
+					+ MakeColumn(GuideTagBrowser::ColumnDepth, LOCTEXT("ColumnDepth", "Nested Depth"), 0.08f)
+					+ MakeColumn(GuideTagBrowser::ColumnReferencedBy, LOCTEXT("ColumnReferencedBy", "Referenced By"), 0.27f)
+				)
+		]
+	];
+
+	RebuildItems();
+}
+
+void SGuideTagBrowser::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	if (true == bItemsDirty)
+	{
+		RebuildItems();
+	}
+}
+
+void SGuideTagBrowser::RebuildItems()
+{
+	bItemsDirty = false;
+
+	AllItems.Reset();
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+	Filter.bRecursiveClasses = true;
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+#else
+	Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+#endif
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	TMap<FName, TArray<FString>> TagReferences;
+
+	for (const FAssetData& Asset : Assets)
+	{
+		FString Value;
+		if (false == Asset.GetTagValue(FGuideMaskAssetTags::TagReferencesName, Value))
+		{
+			continue;
+		}
+
+		TArray<FName> Tags;
+		FGuideMaskAssetTags::ImportTagReferences(Value, Tags);
+
+		for (const FName& Tag : Tags)
+		{
+			TagReferences.FindOrAdd(Tag).AddUnique(Asset.AssetName.ToString());
+		}
+	}
+
+	for (const FAssetData& Asset : Assets)
+	{
+		FString Value;
+		if (false == Asset.GetTagValue(FGuideMaskAssetTags::TagListName, Value))
+		{
+			continue;
+		}
+
+		TArray<FGuideTagRecord> Records;
+		FGuideMaskAssetTags::ImportTagRecords(Value, Records);
+
+		for (const FGuideTagRecord& Record : Records)
+		{
+			FItemPtr Item = MakeShared<FGuideTagBrowserItem>();
+			Item->Tag = Record.Tag;
+			Item->WidgetName = Record.WidgetName;
+			Item->WidgetClass = Record.WidgetClass;
+			Item->ContainerDepth = Record.ContainerDepth;
+			Item->BlueprintName = Asset.AssetName.ToString();
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+			Item->BlueprintPath = Asset.GetSoftObjectPath();
+#else
+			Item->BlueprintPath = Asset.ToSoftObjectPath();
+#endif
+
+			if (const TArray<FString>* References = TagReferences.Find(Record.Tag))
+			{
+				Item->ReferencedBy = *References;
+			}
+
+			Item->SearchText = FString::Join(TArray<FString>
+				{
+					Item->Tag.ToString(),
+					Item->BlueprintName,
+					Item->WidgetName,
+					Item->WidgetClass,
+					FString::Join(Item->ReferencedBy, TEXT(" "))
+				}, TEXT(" ")).ToLower();
+
+			AllItems.Emplace(MoveTemp(Item));
+		}
+	}
+
+	SortItems(AllItems);
+	RebuildFilter();
+}
+
+void SGuideTagBrowser::RebuildFilter()
+{
+	FilteredItems.Reset();
+
+	if (true == LowerFilterString.IsEmpty())
+	{
+		FilteredItems = AllItems;
+	}
+
+	else
+	{
+		// Every word has to match somewhere in the row.
+		TArray<FString> Words;
+		LowerFilterString.ParseIntoArrayWS(Words);
+
+		for (const FItemPtr& Item : AllItems)
+		{
+			const bool bMatch = false == Words.ContainsByPredicate([&Item](const FString& InWord)
+				{
+					return false == Item->SearchText.Contains(InWord, ESearchCase::CaseSensitive);
+				});
+
+			if (true == bMatch)
+			{
+				FilteredItems.Emplace(Item);
+			}
+		}
+	}
+
+	if (ListView.IsValid())
+	{
+		ListView->RequestListRefresh();
+	}
+}
+
+void SGuideTagBrowser::SortItems(TArray<FItemPtr>& InOutItems) const
+{
+	const bool bAscending = EColumnSortMode::Descending != SortMode;
+	const FName Column = SortColumn;
+
+	InOutItems.StableSort([bAscending, Column](const FItemPtr& A, const FItemPtr& B)
+		{
+			int32 Compare = 0;
+
+			if (GuideTagBrowser::ColumnBlueprint == Column)
+			{
+				Compare = A->BlueprintName.Compare(B->BlueprintName, ESearchCase::IgnoreCase);
+			}
+
+			else if (GuideTagBrowser::ColumnWidget == Column)
+			{
+				Compare = A->WidgetName.Compare(B->WidgetName, ESearchCase::IgnoreCase);
+			}
+
+			else if (GuideTagBrowser::ColumnClass == Column)
+			{
+				Compare = A->WidgetClass.Compare(B->WidgetClass, ESearchCase::IgnoreCase);
+			}
+
+			else if (GuideTagBrowser::ColumnDepth == Column)
+			{
+				Compare = A->ContainerDepth - B->ContainerDepth;
+			}
+
+			else if (GuideTagBrowser::ColumnReferencedBy == Column)
+			{
+				Compare = A->ReferencedBy.Num() - B->ReferencedBy.Num();
+			}
+
+			else
+			{
+				Compare = A->Tag.Compare(B->Tag);
+			}
+
+			return bAscending ? Compare < 0 : Compare > 0;
+		});
+}
+
+TSharedRef<ITableRow> SGuideTagBrowser::OnGenerateRow(FItemPtr InItem, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	const FSoftObjectPath BlueprintPath = InItem->BlueprintPath;
+
+	return SNew(SGuideTagBrowserRow, OwnerTable, InItem)
+		.HighlightText_Lambda([this]()
+			{
+				return FilterText;
+			})
+		.OnOpenClicked_Lambda([BlueprintPath]()
+			{
+				return SGuideTagBrowser::OpenOwningBlueprint(BlueprintPath);
+			});
+}
+
+void SGuideTagBrowser::OnFilterTextChanged(const FText& InText)
+{
+	FilterText = InText;
+	LowerFilterString = InText.ToString().ToLower();
+
+	RebuildFilter();
+}
+
+void SGuideTagBrowser::OnSortModeChanged(EColumnSortPriority::Type InPriority, const FName& InColumn, EColumnSortMode::Type InSortMode)
+{
+	SortColumn = InColumn;
+	SortMode = InSortMode;
+
+	SortItems(AllItems);
+	SortItems(FilteredItems);
+
+	if (ListView.IsValid())
+	{
+		ListView->RequestListRefresh();
+	}
+}
+
+EColumnSortMode::Type SGuideTagBrowser::GetSortMode(FName InColumn) const
+{
+	return InColumn == SortColumn ? SortMode : EColumnSortMode::None;
+}
+
+void SGuideTagBrowser::OnItemDoubleClicked(FItemPtr InItem)
+{
+	if (InItem.IsValid())
+	{
+		OpenOwningBlueprint(InItem->BlueprintPath);
+	}
+}
+
+FReply SGuideTagBrowser::OnRefreshClicked()
+{
+	RebuildItems();
+	return FReply::Handled();
+}
+
+void SGuideTagBrowser::OnAssetChanged(const FAssetData& InAssetData)
+{
+	bItemsDirty = true;
+}
+
+FReply SGuideTagBrowser::OpenOwningBlueprint(const FSoftObjectPath& InBlueprintPath)
+{
+	// The only place the browser loads an asset.
+	return FGuideHierarchyNodeCustomization::OpenBlueprint(Cast<UBlueprint>(InBlueprintPath.TryLoad()));
+}
+
+#undef LOCTEXT_NAMESPACE
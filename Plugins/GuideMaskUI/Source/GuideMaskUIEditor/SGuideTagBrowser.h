@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+struct FAssetData;
+
+struct FGuideTagBrowserItem
+{
+	FName Tag;
+	FString WidgetName;
+	FString WidgetClass;
+	int32 ContainerDepth = 0;
+
+	FSoftObjectPath BlueprintPath;
+	FString BlueprintName;
+
+	// Blueprints passing this tag to a guide function.
+	TArray<FString> ReferencedBy;
+
+	// Lower case text of every column, filtering is a single Contains per row.
+	FString SearchText;
+};
+
+/**
+ * Every guide tag in the project, read from asset registry data only.
+ */
+class SGuideTagBrowser : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SGuideTagBrowser) {}
+	SLATE_END_ARGS()
+
+	static const FName TabName;
+
+	virtual ~SGuideTagBrowser();
+
+	void Construct(const FArguments& InArgs);
+
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+
+private:
+	typedef TSharedPtr<FGuideTagBrowserItem> FItemPtr;
+
+	void RebuildItems();
+	void RebuildFilter();
+	void SortItems(TArray<FItemPtr>& InOutItems) const;
+
+	TSharedRef<ITableRow> OnGenerateRow(FItemPtr InItem, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnFilterTextChanged(const FText& InText);
+	void OnSortModeChanged(EColumnSortPriority::Type InPriority, const FName& InColumn, EColumnSortMode::Type InSortMode);
+	EColumnSortMode::Type GetSortMode(FName InColumn) const;
+	void OnItemDoubleClicked(FItemPtr InItem);
+	FReply OnRefreshClicked();
+
+	void OnAssetChanged(const FAssetData& InAssetData);
+
+	static FReply OpenOwningBlueprint(const FSoftObjectPath& InBlueprintPath);
+
+private:
+	TSharedPtr<SListView<FItemPtr>> ListView;
+
+	TArray<FItemPtr> AllItems;
+	TArray<FItemPtr> FilteredItems;
+
+	FText FilterText;
+	FString LowerFilterString;
+
+	FName SortColumn;
+	EColumnSortMode::Type SortMode = EColumnSortMode::Ascending;
+
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle AssetRemovedHandle;
+
+	// Saves come in bursts, the list is rebuilt once on the next tick.
+	bool bItemsDirty = false;
+};